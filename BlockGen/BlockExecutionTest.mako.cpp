@@ -189,3 +189,28 @@ POTHOS_TEST_BLOCK("/numpy/tests", test_block_execution)
     testAutoBlockExecution<std::complex<float>>();
     testAutoBlockExecution<std::complex<double>>();
 }
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_fast_math)
+{
+%for blockName,blockInfo in blockYAML.items():
+    %if "fastMath" in blockInfo:
+    NPTests::testFastMath(
+        "/numpy/${blockName}",
+        ${blockInfo["fastMath"]["low"]},
+        ${blockInfo["fastMath"]["high"]},
+        ${blockInfo["fastMath"]["maxRelError"]},
+        ${blockInfo["fastMath"]["maxAbsError"]},
+        ${blockInfo["fastMath"].get("maxArgError", 0.0)},
+        ${"true" if ("complex" in blockInfo["blockType"]) else "false"});
+    %endif
+%endfor
+
+    // Blocks without known error bounds don't support FAST precision.
+    auto block = Pothos::BlockRegistry::make(
+                     "/numpy/deg2rad",
+                     "float64");
+    block.call("setPrecision", "FULL");
+    POTHOS_TEST_THROWS(
+        block.call("setPrecision", "FAST"),
+        Pothos::ProxyExceptionMessage);
+}
@@ -94,7 +94,7 @@ def processYAMLFile(yamlPath):
                 raise RuntimeError('Could not find template entry: "{0}".'.format(v["copy"]))
 
             fullEntry = templateEntries[v["copy"]].copy()
-            for keyToErase in ["alias", "niceName", "description"]:
+            for keyToErase in ["alias", "niceName", "description", "fastMath"]:
                 if keyToErase in fullEntry:
                     del fullEntry[keyToErase]
             fullEntry.update(v)
@@ -110,20 +110,21 @@ def generateCppFactory(func,name):
            .format(func, name)
 
 def formatTypeText(typeText):
-    return typeText.title().replace("Uint", "UInt")
+    return typeText.title().replace("Uint", "UInt").replace("Cint", "CInt")
 
 def blockTypeToDictString(blockTypeYAML):
     return "dict({0})".format(", ".join(["support{0}=True".format(formatTypeText(typeText)) for typeText in blockTypeYAML]))
 
 def blockTypeToDTypeChooser(blockTypeYAML):
     if "all" in blockTypeYAML:
-        yamlToProcess = ["int", "uint", "float", "complex"]
+        yamlToProcess = ["int", "uint", "float", "complex"] + [typeStr for typeStr in blockTypeYAML if typeStr != "all"]
     else:
         yamlToProcess = blockTypeYAML
 
+    # The DTypeChooser's "dim" option allows vector DTypes.
     args = dict()
     for typeStr in yamlToProcess:
-        args[typeStr.replace("complex","cfloat")] = 1
+        args[typeStr.replace("complex","cfloat").replace("vector","dim")] = 1
 
     return args
 
@@ -238,7 +239,7 @@ def generateMakoVars(func,yaml):
         makoVars["funcArgsList"] = ["self.{0}".format(arg["privateVar"]) for arg in yaml["funcArgs"]]
 
     # Some keys are just straight copies.
-    for key in ["alias", "niceName", "funcArgs", "factoryPrefix", "nanFunc"]:
+    for key in ["alias", "niceName", "funcArgs", "factoryPrefix", "nanFunc", "fastMath", "elementwise", "backendThreads"]:
         if key in yaml:
             makoVars[key] = yaml[key]
 
@@ -252,9 +253,14 @@ def generateMakoVars(func,yaml):
         makoVars["factoryVars"] += ["args"]
         makoVars["args"] = "[{0}]".format(", ".join(yaml["args"]))
 
-    if "kwargs" in yaml:
+    # Blocks with error bounds for single-precision evaluation can use it, and
+    # element-wise blocks can be tiled and fused.
+    kwargs = list(yaml.get("kwargs", []))
+    kwargs += (["fastMathRange=({0}, {1})".format(yaml["fastMath"]["low"], yaml["fastMath"]["high"])] if "fastMath" in yaml else [])
+    kwargs += (["elementwise=True"] if yaml.get("elementwise", False) else [])
+    if kwargs:
         makoVars["factoryVars"] += ["kwargs"]
-        makoVars["kwargs"] = "dict({0})".format(", ".join(yaml["kwargs"]))
+        makoVars["kwargs"] = "dict({0})".format(", ".join(kwargs))
 
     if "funcArgs" in yaml:
         assert(type(yaml["funcArgs"]) is list)
@@ -286,8 +292,8 @@ def generateMakoVars(func,yaml):
             raise RuntimeError("Invalid block type.")
     elif "blockPattern" in yaml:
         if yaml["blockPattern"] == "ComplexToScalar":
-            yaml["inputType"] = ["complex"]
-            yaml["outputType"] = ["float"]
+            yaml["inputType"] = ["complex", "cint", "vector"]
+            yaml["outputType"] = ["float", "vector"]
             processBlock(yaml, makoVars)
         else:
             raise RuntimeError("Invalid block pattern.")
@@ -436,6 +442,79 @@ def makoVarsToBlockDesc(makoVars):
 
             desc["params"].append(param)
 
+        if "fastMath" in makoVars:
+            fastMath = makoVars["fastMath"]
+            errorTerms = []
+            if fastMath["maxRelError"] > 0:
+                errorTerms += ["{0:g}*|y|".format(fastMath["maxRelError"])]
+            if fastMath["maxAbsError"] > 0:
+                errorTerms += ["{0:g}".format(fastMath["maxAbsError"])]
+            if fastMath.get("maxArgError", 0) > 0:
+                errorTerms += ["{0:g}*|x|".format(fastMath["maxArgError"])]
+
+            complexErrorDesc = []
+            if "supportComplex=True" in makoVars["outputDTypeArgs"]:
+                complexErrorDesc = ["For complex inputs, the range applies to the real and imaginary parts, and",
+                                    "the bound to magnitudes."]
+
+            desc["params"].append(dict(
+                key="precision",
+                name="Precision",
+                desc=["In <b>FAST</b> mode, 64-bit inputs are evaluated in single precision, where NumPy's",
+                      "kernels for this function are several times faster. If any input in a buffer is",
+                      "outside the range below, results that overflow or underflow in single precision are",
+                      "recomputed in full precision.",
+                      "",
+                      "For inputs <b>x</b> in <b>[{0:g}, {1:g}]</b>, the error is at most".format(fastMath["low"], fastMath["high"]),
+                      "<b>{0}</b>, where <b>y</b> is the full-precision result.".format(" + ".join(errorTerms))] + complexErrorDesc,
+                default="\"FULL\"",
+                preview="disable",
+                widgetType="ComboBox",
+                widgetKwargs=dict(editable="false"),
+                options=[dict(name="Full", value="\"FULL\""), dict(name="Fast", value="\"FAST\"")]))
+            desc["calls"].append(dict(
+                type="setter",
+                name="setPrecision",
+                args="precision"))
+
+        # Element-wise blocks can split large buffers into tiles processed on
+        # the shared thread pool.
+        if makoVars.get("elementwise", False) and (makoVars["class"] in ["OneToOneBlock", "TwoToOneBlock"]):
+            desc["params"].append(dict(
+                key="numThreads",
+                name="Num Threads",
+                desc=["The number of threads to process tiles of large buffers on, or 0 for the global default.",
+                      "Only input buffers larger than a tile (8192 elements) are split, which the default 8 KiB",
+                      "buffers never are, so this only helps downstream of blocks that post larger buffers."],
+                default="0",
+                preview="disable",
+                widgetType="SpinBox",
+                widgetKwargs=dict(minimum=0)))
+            desc["calls"].append(dict(
+                type="setter",
+                name="setNumThreads",
+                args="numThreads"))
+
+        # Blocks whose functions call into NumPy's BLAS library can limit its
+        # threads.
+        if makoVars.get("backendThreads", False):
+            desc["params"].append(dict(
+                key="backendNumThreads",
+                name="Backend Num Threads",
+                desc=["The maximum number of threads NumPy's BLAS library may use while this block exists,",
+                      "or 0 for no block-specific limit. The backend's thread count is process-wide, so",
+                      "every NumPy block, and anything else in the process using the same library, uses",
+                      "the smallest of the global limit and every block's limit. Requires the threadpoolctl",
+                      "module."],
+                default="0",
+                preview="disable",
+                widgetType="SpinBox",
+                widgetKwargs=dict(minimum=0)))
+            desc["calls"].append(dict(
+                type="setter",
+                name="setBackendNumThreads",
+                args="backendNumThreads"))
+
     # Encode the block description into escaped JSON
     descEscaped = "".join([hex(ord(ch)).replace("0x", "\\x") for ch in json.dumps(desc)])
     return "Pothos::PluginRegistry::add(\"{0}\", std::string(\"{1}\"));".format(makoVars["docRegistryPath"], descEscaped)
@@ -16,6 +16,38 @@ static std::string getNumPyConfigInfoJSONString()
     return PothosNumPy.call<std::string>("getNumPyConfigInfoJSONString");
 }
 
+static std::string getNumPyCPUInfoJSONString()
+{
+    auto pythonEnv = Pothos::ProxyEnvironment::make("python");
+    auto PothosNumPy = pythonEnv->findProxy("PothosNumPy");
+
+    return PothosNumPy.call<std::string>("getNumPyCPUInfoJSONString");
+}
+
+static std::string getNumPyThreadInfoJSONString()
+{
+    auto pythonEnv = Pothos::ProxyEnvironment::make("python");
+    auto PothosNumPy = pythonEnv->findProxy("PothosNumPy");
+
+    return PothosNumPy.call<std::string>("getThreadInfoJSONString");
+}
+
+static void setNumPyDefaultNumThreads(size_t numThreads)
+{
+    auto pythonEnv = Pothos::ProxyEnvironment::make("python");
+    auto PothosNumPy = pythonEnv->findProxy("PothosNumPy");
+
+    PothosNumPy.call("setDefaultNumThreads", numThreads);
+}
+
+static void setNumPyBackendNumThreads(size_t numThreads)
+{
+    auto pythonEnv = Pothos::ProxyEnvironment::make("python");
+    auto PothosNumPy = pythonEnv->findProxy("PothosNumPy");
+
+    PothosNumPy.call("setBackendNumThreads", numThreads);
+}
+
 static Pothos::Proxy getNumPyIntInfo(const Pothos::DType& dtype)
 {
     auto pythonEnv = Pothos::ProxyEnvironment::make("python");
@@ -38,6 +70,22 @@ pothos_static_block(registerCalls)
         "/devices/numpy/info",
         Pothos::Callable(getNumPyConfigInfoJSONString));
 
+    Pothos::PluginRegistry::addCall(
+        "/devices/numpy/cpu_info",
+        Pothos::Callable(getNumPyCPUInfoJSONString));
+
+    Pothos::PluginRegistry::addCall(
+        "/devices/numpy/thread_info",
+        Pothos::Callable(getNumPyThreadInfoJSONString));
+
+    Pothos::PluginRegistry::addCall(
+        "/numpy/threads/set_default_num_threads",
+        Pothos::Callable(setNumPyDefaultNumThreads));
+
+    Pothos::PluginRegistry::addCall(
+        "/numpy/threads/set_backend_num_threads",
+        Pothos::Callable(setNumPyBackendNumThreads));
+
     Pothos::PluginRegistry::addCall(
         "/numpy/typeinfo/finfo",
         Pothos::Callable(getNumPyFloatInfo));
@@ -0,0 +1,164 @@
+# Copyright (c) 2019-2020 Nicholas Corgan
+# SPDX-License-Identifier: BSD-3-Clause
+
+from .OneToOneBlock import *
+from . import Utility
+
+import Pothos
+
+import numpy
+
+OverflowModes = ["WRAP", "SATURATE"]
+
+class AsTypeBlock(OneToOneBlock):
+    def __init__(self, inputDType, outputDType):
+        dtypeArgs = dict(supportAll=True)
+        kwargs = dict(useDType=False)
+        OneToOneBlock.__init__(self, "/numpy/astype", numpy.copyto, inputDType, outputDType, dtypeArgs, dtypeArgs, list(), dict(), **kwargs)
+
+        self.__toReal = (self.numpyInputDType.kind == "c") and (self.numpyOutputDType.kind != "c")
+
+        self.registerProbe("overflow")
+        self.registerProbe("scale")
+
+        self.registerSignal("overflowChanged")
+        self.registerSignal("scaleChanged")
+
+        self.setOverflow("WRAP")
+        self.setScale(1.0)
+
+    def overflow(self):
+        return self.__overflow
+
+    def setOverflow(self, overflow):
+        if overflow not in OverflowModes:
+            raise ValueError("Invalid overflow mode: {0}".format(overflow))
+
+        self.__overflow = overflow
+
+        # C++ equivalent: emitSignal("overflowChanged", overflow)
+        self.overflowChanged(overflow)
+
+    def scale(self):
+        return self.__scale
+
+    def setScale(self, scale):
+        self.__scale = float(scale)
+
+        # Scaled values are computed as floats, so the bounds, and whether
+        # floats are converted to integers, depend on whether there is a
+        # scale factor.
+        workingDType = self.numpyInputDType
+        if (1.0 != self.__scale) and (workingDType.kind in "iu"):
+            workingDType = numpy.dtype("float64")
+        self.__bounds = Utility.getSaturationBounds(workingDType, self.numpyOutputDType)
+        self.__floatToInt = (workingDType.kind in "fc") and (self.numpyOutputDType.kind in "iu")
+
+        # C++ equivalent: emitSignal("scaleChanged", scale)
+        self.scaleChanged(scale)
+
+    def __saturate(self, values):
+        if self.__floatToInt:
+            # NaN has no integer equivalent.
+            values = numpy.nan_to_num(values, nan=0.0, posinf=self.__bounds[1], neginf=self.__bounds[0])
+        if "c" == values.dtype.kind:
+            # Clip the real and imaginary parts independently.
+            values = numpy.ascontiguousarray(values)
+            return numpy.clip(values.view(Utility.scalarDType(values.dtype)), *self.__bounds).view(values.dtype)
+
+        return numpy.clip(values, *self.__bounds)
+
+    def __wrap(self, values):
+        # Casting out-of-range floats to integers is undefined, so reduce
+        # the truncated values into the output range first.
+        numBits = 8 * self.numpyOutputDType.itemsize
+        values = numpy.mod(numpy.trunc(values), float(2**numBits))
+        if "i" == self.numpyOutputDType.kind:
+            values[values >= 2**(numBits-1)] -= float(2**numBits)
+
+        # Only values that round to the edge of the range are affected.
+        return numpy.clip(values, *self.__bounds, out=values)
+
+    def convert(self, values, out):
+        if self.__toReal:
+            values = values.real
+        if 1.0 != self.__scale:
+            values = values * self.__scale
+
+        if ("SATURATE" == self.__overflow) and (self.__bounds is not None):
+            values = self.__saturate(values)
+        elif self.__floatToInt:
+            values = self.__wrap(values)
+
+        # Integer-to-integer wrapping is what an unchecked cast does anyway.
+        self.func(out, values, casting="unsafe")
+
+    def work(self):
+        elems = self.workInfo().minAllElements
+        if 0 == elems:
+            return
+
+        in0 = self.input(0).buffer()
+        out0 = self.output(0).buffer()
+        N = min(len(in0), len(out0))
+
+        self.convert(in0[:N], out0[:N])
+
+        self.input(0).consume(N)
+        self.output(0).produce(N)
+
+#
+# Factories exposed to C++ layer
+#
+
+"""
+/*
+ * |PothosDoc As Type
+ *
+ * Convert the input to another type.
+ *
+ * Complex inputs converted to a scalar type keep only their real part, and
+ * floating-point inputs converted to an integer type are truncated toward
+ * zero. Values that don't fit in the output type either wrap around, as an
+ * unchecked cast would, or saturate at the output type's limits. When
+ * saturating, NaN becomes 0.
+ *
+ * An optional scale factor is applied before the conversion, so converting
+ * from a normalized float to an integer type can be done in one pass.
+ *
+ * Conversions that can't overflow, such as widening an integer, are a
+ * single copy.
+ *
+ * Corresponding NumPy function: <b>numpy.ndarray.astype</b>
+ *
+ * |category /NumPy/Stream
+ * |keywords numpy astype type convert cast saturate wrap scale
+ * |factory /numpy/astype(inputDType,outputDType)
+ * |setter setOverflow(overflow)
+ * |setter setScale(scale)
+ *
+ * |param inputDType[Input Data Type] The input data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1,cfloat=1)
+ * |default "int16"
+ * |preview disable
+ *
+ * |param outputDType[Output Data Type] The output data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1,cfloat=1)
+ * |default "float32"
+ * |preview disable
+ *
+ * |param overflow[Overflow] How to handle values outside the output type's range.
+ * |widget ComboBox(editable=False)
+ * |default "WRAP"
+ * |option [Wrap] "WRAP"
+ * |option [Saturate] "SATURATE"
+ * |preview enable
+ *
+ * |param scale[Scale] A factor applied to each value before conversion.
+ * |widget DoubleSpinBox()
+ * |default 1.0
+ * |preview enable
+ */
+"""
+def AsType(inputDType, outputDType):
+    return AsTypeBlock(inputDType, outputDType)
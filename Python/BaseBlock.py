@@ -1,6 +1,7 @@
 # Copyright (c) 2019 Nicholas Corgan
 # SPDX-License-Identifier: BSD-3-Clause
 
+from . import ThreadPool
 from . import Utility
 
 import Pothos
@@ -24,8 +25,18 @@ class BaseBlock(Pothos.Block):
         self.callPostBuffer = kwargs.get("callPostBuffer", False)
         self.sizeParam = kwargs.get("sizeParam", False)
 
+        # Blocks that support it split large buffers into tiles processed on
+        # the shared thread pool. 0 means the global default.
+        self.__numThreads = 0
+        self.__backendNumThreads = 0
+
         self.initDTypes(inputDType, outputDType, inputDTypeArgs, outputDTypeArgs)
 
+        # Some functions don't need complex integers to be widened.
+        self.complexIntPairFunc = None
+        if (self.inputComplexIntDType is not None) and (self.inputComplexIntDType == self.outputComplexIntDType):
+            self.complexIntPairFunc = Utility.ComplexIntPairFuncs.get(func)
+
         # Set up logging for this block
         self.logger = logging.getLogger(blockPath)
         self.logger.addHandler(Pothos.LogHandler(blockPath))
@@ -42,9 +53,91 @@ class BaseBlock(Pothos.Block):
         self.outputDType = outputDType
 
         # Other values to assemble from user input
-        self.numpyInputDType = None if inputDType is None else Pothos.Buffer.dtype_to_numpy(self.inputDType)
-        self.numpyOutputDType = None if outputDType is None else Pothos.Buffer.dtype_to_numpy(self.outputDType)
+        self.numpyInputDType = None if inputDType is None else Utility.dtypeToNumPy(self.inputDType)
+        self.numpyOutputDType = None if outputDType is None else Utility.dtypeToNumPy(self.outputDType)
+
+        # For complex integer types, the integer type of each component
+        self.inputComplexIntDType = Utility.complexIntScalarDType(self.inputDType)
+        self.outputComplexIntDType = Utility.complexIntScalarDType(self.outputDType)
+
+        # For vector types, each element is a frame of this many values.
+        self.inputDimension = 1 if inputDType is None else inputDType.dimension()
+        self.outputDimension = 1 if outputDType is None else outputDType.dimension()
 
         if self.useDType:
             self.funcKWargs["dtype"] = self.numpyInputDType if self.numpyInputDType is not None else self.numpyOutputDType
 
+    def numThreads(self):
+        return self.__numThreads if (self.__numThreads > 0) else ThreadPool.defaultNumThreads()
+
+    def setNumThreads(self, numThreads):
+        if numThreads < 0:
+            raise ValueError("numThreads cannot be negative.")
+
+        self.__numThreads = numThreads
+
+    # Returns where to write the output for numElements input elements, and
+    # whether it will be posted rather than produced. The default output
+    # buffers never hold more than one tile, so when upstream hands this block
+    # more than that and it has threads to split it across, it writes to a
+    # buffer of its own to post instead.
+    def getTiledOutputBuffer(self, numElements):
+        out0 = self.output(0).buffer()
+        canSplit = (ThreadPool.getUsableNumThreads(self.numThreads()) > 1) and (numElements > Utility.ElementwiseTileElements)
+        if canSplit and (numElements > len(out0)) and (self.outputComplexIntDType is None) and (1 == self.outputDimension):
+            return (numpy.empty(numElements, dtype=self.numpyOutputDType), True)
+
+        return (out0[:min(numElements, len(out0))], False)
+
+    def finishTiledOutput(self, outBuf, isPosted):
+        if isPosted:
+            self.output(0).postBuffer(outBuf)
+        else:
+            self.output(0).produce(len(outBuf))
+
+    # The number of threads NumPy's BLAS library may use while this block
+    # exists, or 0 for no per-block limit
+    def backendNumThreads(self):
+        return self.__backendNumThreads
+
+    def setBackendNumThreads(self, numThreads):
+        ThreadPool.setBlockBackendNumThreads(self, numThreads)
+        self.__backendNumThreads = numThreads
+
+    #
+    # Complex integer support
+    #
+
+    # Returns the given input buffer in a form NumPy can process.
+    def toNumPyInput(self, buf):
+        if self.inputComplexIntDType is None:
+            return buf
+
+        return Utility.complexIntToComplexFloat(buf, self.inputComplexIntDType)
+
+    # Returns the given output values in a form that can be posted.
+    def fromNumPyOutput(self, values):
+        if self.outputComplexIntDType is None:
+            return values
+
+        return Utility.complexFloatToComplexInt(values, self.outputComplexIntDType)
+
+    def writeOutput(self, outBuf, values):
+        if self.outputComplexIntDType is None:
+            outBuf[:] = values
+        else:
+            Utility.complexFloatToComplexInt(values, self.outputComplexIntDType, out=outBuf)
+
+    # Applies self.complexIntPairFunc across the given input buffers without
+    # widening them.
+    def callComplexIntPairFunc(self, inBufs, outBuf):
+        pairs = [Utility.complexIntPairs(buf, self.inputComplexIntDType) for buf in inBufs]
+        outPairs = Utility.complexIntPairs(outBuf, self.outputComplexIntDType)
+
+        if 1 == len(pairs):
+            self.complexIntPairFunc(pairs[0], out=outPairs)
+        else:
+            self.complexIntPairFunc(pairs[0], pairs[1], out=outPairs)
+            for otherPairs in pairs[2:]:
+                self.complexIntPairFunc(outPairs, otherPairs, out=outPairs)
+
@@ -0,0 +1,183 @@
+# Copyright (c) 2019-2020 Nicholas Corgan
+# SPDX-License-Identifier: BSD-3-Clause
+
+from .BaseBlock import *
+from . import Utility
+
+import Pothos
+
+import numpy
+
+#
+# Decimating reductions
+#
+# Each output is a reduction of the next decimation input values. Whole
+# frames in a buffer are reduced at once through an (frames, decimation)
+# view, and values that don't fill a frame are kept for the next call.
+#
+
+def rms(values, axis=None):
+    # Squares of integers would overflow.
+    if values.dtype.kind in "iu":
+        values = values.astype(numpy.float64)
+
+    magnitudes = numpy.abs(values)
+    return numpy.sqrt(numpy.mean(magnitudes * magnitudes, axis=axis))
+
+# The range of signed integers can exceed their type's maximum, but always
+# fits in the unsigned type of the same size, where the subtraction wraps to
+# the right value.
+def ptp(values, axis=None):
+    if "i" == values.dtype.kind:
+        unsignedDType = numpy.dtype("u{0}".format(values.dtype.itemsize))
+        return numpy.max(values, axis=axis).astype(unsignedDType) - numpy.min(values, axis=axis).astype(unsignedDType)
+
+    return numpy.ptp(values, axis=axis)
+
+# Reduction name: (function, whether it's defined for complex values, whether
+# integer values are reduced to floating-point)
+BlockReductions = dict(
+    SUM=(numpy.sum, True, False),
+    MEAN=(numpy.mean, True, True),
+    MAX=(numpy.max, False, False),
+    MIN=(numpy.min, False, False),
+    RMS=(rms, True, True),
+    PTP=(ptp, False, False)
+)
+
+class BlockReduceBlock(BaseBlock):
+    def __init__(self, dtype, reduction, decimation):
+        dtype = Utility.toDType(dtype)
+
+        if reduction not in BlockReductions:
+            raise ValueError("Invalid reduction: {0}. Valid values: {1}".format(reduction, ", ".join(sorted(BlockReductions.keys()))))
+        if decimation < 1:
+            raise ValueError("decimation must be at least 1.")
+
+        (func, supportComplex, toFloat) = BlockReductions[reduction]
+
+        isInteger = (not dtype.isFloat()) and (not dtype.isComplex())
+        if toFloat and isInteger:
+            outputDType = Utility.DType("float64")
+        elif (reduction == "SUM") and isInteger:
+            # As with numpy.sum, so sums of small integers don't wrap
+            outputDType = Utility.DType("int64" if dtype.isSigned() else "uint64")
+        elif (reduction == "PTP") and isInteger and dtype.isSigned():
+            outputDType = Utility.DType(dtype.name().replace("int", "uint"))
+        elif reduction == "RMS":
+            outputDType = Utility.dtypeToScalar(dtype)
+        else:
+            outputDType = dtype
+
+        inputDTypeArgs = dict(supportInt=True, supportUInt=True, supportFloat=True, supportComplex=supportComplex)
+        outputDTypeArgs = dict(supportInt=True, supportUInt=True, supportFloat=True, supportComplex=True)
+        BaseBlock.__init__(self, "/numpy/block_reduce", func, dtype, outputDType, inputDTypeArgs, outputDTypeArgs, list(), dict(), useDType=False)
+
+        self.__reduction = reduction
+        self.__decimation = decimation
+        self.__partialFrame = numpy.zeros(0, dtype=self.numpyInputDType)
+
+        self.setupInput(0, self.inputDType)
+        self.setupOutput(0, self.outputDType)
+
+        self.registerProbe("reduction")
+        self.registerProbe("decimation")
+
+    def reduction(self):
+        return self.__reduction
+
+    def decimation(self):
+        return self.__decimation
+
+    def work(self):
+        in0 = self.input(0).buffer()
+        out0 = self.output(0).buffer()
+        if (0 == len(in0)) or (0 == len(out0)):
+            return
+
+        N = self.__decimation
+        numOutputs = 0
+        numConsumed = 0
+
+        # Finish the frame started in a previous call.
+        if len(self.__partialFrame) > 0:
+            numConsumed = min(N - len(self.__partialFrame), len(in0))
+            self.__partialFrame = numpy.concatenate([self.__partialFrame, in0[:numConsumed]])
+
+            if len(self.__partialFrame) == N:
+                out0[0] = self.func(self.__partialFrame)
+                self.__partialFrame = self.__partialFrame[:0]
+                numOutputs = 1
+
+        # Reduce every whole frame left in one call.
+        if 0 == len(self.__partialFrame):
+            numFrames = min((len(in0) - numConsumed) // N, len(out0) - numOutputs)
+            if numFrames > 0:
+                frames = in0[numConsumed:numConsumed + (numFrames * N)].reshape((numFrames, N))
+                out0[numOutputs:numOutputs + numFrames] = self.func(frames, axis=1)
+
+                numConsumed += (numFrames * N)
+                numOutputs += numFrames
+
+            # Keep what's left of the buffer if the output has room for it.
+            if (numOutputs < len(out0)) and (numConsumed < len(in0)):
+                self.__partialFrame = in0[numConsumed:].copy()
+                numConsumed = len(in0)
+
+        self.input(0).consume(numConsumed)
+        if numOutputs > 0:
+            self.output(0).produce(numOutputs)
+
+#
+# Factories exposed to C++ layer
+#
+
+"""
+/*
+ * |PothosDoc Block Reduce
+ *
+ * Reduce every <b>decimation</b> input values to one output value.
+ *
+ * All whole frames in a buffer are reduced with a single NumPy call, and
+ * values left over at the end of a buffer are carried into the next frame,
+ * so every output covers exactly <b>decimation</b> consecutive inputs.
+ *
+ * <ul>
+ * <li><b>SUM</b>: <b>numpy.sum</b>, as <b>int64</b> or <b>uint64</b> for integer inputs</li>
+ * <li><b>MEAN</b>: <b>numpy.mean</b>, as <b>float64</b> for integer inputs</li>
+ * <li><b>MAX</b>: <b>numpy.max</b></li>
+ * <li><b>MIN</b>: <b>numpy.min</b></li>
+ * <li><b>RMS</b>: the root mean square of the values' magnitudes, as <b>float64</b> for integer inputs</li>
+ * <li><b>PTP</b>: <b>numpy.ptp</b>, the peak-to-peak range, as the unsigned type of the same size for signed integer inputs</li>
+ * </ul>
+ *
+ * <b>MAX</b>, <b>MIN</b> and <b>PTP</b> don't support complex inputs.
+ *
+ * |category /NumPy/Stats
+ * |keywords sum mean average max min rms ptp decimate reduce downsample
+ * |factory /numpy/block_reduce(dtype,reduction,decimation)
+ *
+ * |param dtype[Input Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1,cfloat=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param reduction[Reduction]
+ * |widget ComboBox(editable=False)
+ * |default "MEAN"
+ * |option [Sum] "SUM"
+ * |option [Mean] "MEAN"
+ * |option [Max] "MAX"
+ * |option [Min] "MIN"
+ * |option [RMS] "RMS"
+ * |option [Peak-to-Peak] "PTP"
+ * |preview enable
+ *
+ * |param decimation[Decimation] The number of input values per output value.
+ * |widget SpinBox(minimum=1)
+ * |default 1024
+ * |preview enable
+ */
+"""
+def BlockReduce(dtype, reduction, decimation):
+    return BlockReduceBlock(dtype, reduction, decimation)
@@ -0,0 +1,276 @@
+# Copyright (c) 2019-2020 Nicholas Corgan
+# SPDX-License-Identifier: BSD-3-Clause
+
+from .BaseBlock import *
+from . import Utility
+
+import Pothos
+
+import numpy
+
+#
+# Stateful cumulative and difference blocks
+#
+# Applying numpy.cumsum and friends to each buffer would restart them at every
+# buffer boundary. These blocks carry running totals and past values across
+# work() calls, so their outputs are what the NumPy function would give for
+# the whole stream.
+#
+
+# Single-precision values are accumulated in double precision.
+AccumulatorDTypes = {
+    numpy.dtype("float32"): numpy.dtype("float64"),
+    numpy.dtype("complex64"): numpy.dtype("complex128")
+}
+
+def getAccumulatorDType(numpyDType):
+    return AccumulatorDTypes.get(numpy.dtype(numpyDType), numpy.dtype(numpyDType))
+
+# The running sum of values, starting from (total + totalError). Each step's
+# rounding error is computed exactly with Knuth's TwoSum, and the prefix sum
+# of those errors is added back, so the error doesn't grow with the number
+# of values. Returns (sums, new total, new totalError).
+def compensatedCumSum(values, total, totalError):
+    sums = numpy.cumsum(numpy.concatenate([[total], values]))
+    previous = sums[:-1]
+    sums = sums[1:]
+
+    valuesPart = sums - previous
+    errors = (previous - (sums - valuesPart)) + (values - valuesPart)
+    corrections = totalError + numpy.cumsum(errors)
+
+    return (sums + corrections, sums[-1], corrections[-1])
+
+class CumulativeBlock(BaseBlock):
+    def __init__(self, blockPath, dtype, dtypeArgs):
+        BaseBlock.__init__(self, blockPath, None, dtype, dtype, dtypeArgs, dtypeArgs, list(), dict(), useDType=False)
+
+        self.setupInput(0, self.inputDType)
+        self.setupOutput(0, self.outputDType)
+
+        self.registerSlot("reset")
+        self.reset()
+
+    # Restarts as if no values have been seen.
+    def reset(self):
+        raise NotImplementedError()
+
+    # Returns the outputs for the given inputs, which may be one fewer.
+    def process(self, values):
+        raise NotImplementedError()
+
+    def work(self):
+        elems = self.workInfo().minAllElements
+        if 0 == elems:
+            return
+
+        out0 = self.output(0).buffer()
+        outputs = self.process(self.input(0).buffer()[:elems])
+
+        out0[:len(outputs)] = outputs
+        self.input(0).consume(elems)
+        if len(outputs) > 0:
+            self.output(0).produce(len(outputs))
+
+class CumSumBlock(CumulativeBlock):
+    def __init__(self, dtype):
+        dtypeArgs = dict(supportInt=True, supportUInt=True, supportFloat=True, supportComplex=True)
+        CumulativeBlock.__init__(self, "/numpy/cumsum", dtype, dtypeArgs)
+
+    def reset(self):
+        accumulatorDType = getAccumulatorDType(self.numpyInputDType)
+        self.__total = accumulatorDType.type(0)
+        self.__totalError = accumulatorDType.type(0)
+
+    def process(self, values):
+        # Integer sums are exact, and wrap like numpy.cumsum.
+        if self.numpyInputDType.kind in "iu":
+            sums = self.__total + numpy.cumsum(values, dtype=self.numpyInputDType)
+            self.__total = sums[-1]
+            return sums
+
+        values = values.astype(getAccumulatorDType(self.numpyInputDType), copy=False)
+        (sums, self.__total, self.__totalError) = compensatedCumSum(values, self.__total, self.__totalError)
+
+        return sums
+
+class CumProdBlock(CumulativeBlock):
+    def __init__(self, dtype):
+        dtypeArgs = dict(supportInt=True, supportUInt=True, supportFloat=True, supportComplex=True)
+        CumulativeBlock.__init__(self, "/numpy/cumprod", dtype, dtypeArgs)
+
+    def reset(self):
+        self.__product = getAccumulatorDType(self.numpyInputDType).type(1)
+
+    def process(self, values):
+        products = self.__product * numpy.cumprod(values, dtype=getAccumulatorDType(self.numpyInputDType))
+        self.__product = products[-1]
+
+        return products
+
+class DiffBlock(CumulativeBlock):
+    def __init__(self, dtype):
+        dtypeArgs = dict(supportInt=True, supportUInt=True, supportFloat=True, supportComplex=True)
+        CumulativeBlock.__init__(self, "/numpy/diff", dtype, dtypeArgs)
+
+    def reset(self):
+        self.__previous = numpy.zeros(0, dtype=self.numpyInputDType)
+
+    # The stream's first value has no previous value, so it has no output.
+    def process(self, values):
+        outputs = numpy.diff(numpy.concatenate([self.__previous, values]))
+        self.__previous = values[-1:].copy()
+
+        return outputs
+
+class GradientBlock(CumulativeBlock):
+    def __init__(self, dtype, spacing):
+        dtypeArgs = dict(supportFloat=True, supportComplex=True)
+        CumulativeBlock.__init__(self, "/numpy/gradient", dtype, dtypeArgs)
+
+        self.setSpacing(spacing)
+        self.registerProbe("spacing")
+
+    def spacing(self):
+        return self.__spacing
+
+    def setSpacing(self, spacing):
+        if spacing <= 0:
+            raise ValueError("spacing must be positive.")
+
+        self.__spacing = spacing
+
+    def reset(self):
+        self.__history = numpy.zeros(0, dtype=self.numpyInputDType)
+        self.__numValues = 0
+
+    # Each value's central difference needs the next value, so outputs lag
+    # inputs by one. The stream's first value uses a one-sided difference, as
+    # numpy.gradient does.
+    def process(self, values):
+        allValues = numpy.concatenate([self.__history, values])
+
+        outputs = (allValues[2:] - allValues[:-2]) / (2 * self.__spacing)
+        if (self.__numValues < 2) and (len(allValues) >= 2):
+            outputs = numpy.concatenate([[(allValues[1] - allValues[0]) / self.__spacing], outputs])
+
+        self.__history = allValues[-2:].copy()
+        self.__numValues += len(values)
+
+        return outputs
+
+#
+# Factories exposed to C++ layer
+#
+
+"""
+/*
+ * |PothosDoc Cumulative Sum
+ *
+ * Return the cumulative sum of the input stream.
+ *
+ * The running total carries over between buffers, so each output is the sum
+ * of every value since the block started or was last reset. Floating-point
+ * sums are compensated: each step's rounding error is computed exactly and
+ * added back, so the error doesn't grow with the length of the stream.
+ * Single-precision values are accumulated in double precision. Integer sums
+ * wrap on overflow.
+ *
+ * Corresponding NumPy function: <b>numpy.cumsum</b>
+ *
+ * |category /NumPy/Arithmetic
+ * |keywords cumsum cumulative sum running total integrate accumulate
+ * |factory /numpy/cumsum(dtype)
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1,cfloat=1)
+ * |default "float64"
+ * |preview disable
+ */
+"""
+def CumSum(dtype):
+    return CumSumBlock(dtype)
+
+"""
+/*
+ * |PothosDoc Cumulative Product
+ *
+ * Return the cumulative product of the input stream.
+ *
+ * The running product carries over between buffers, so each output is the
+ * product of every value since the block started or was last reset.
+ * Single-precision values are accumulated in double precision.
+ *
+ * Corresponding NumPy function: <b>numpy.cumprod</b>
+ *
+ * |category /NumPy/Arithmetic
+ * |keywords cumprod cumulative product running
+ * |factory /numpy/cumprod(dtype)
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1,cfloat=1)
+ * |default "float64"
+ * |preview disable
+ */
+"""
+def CumProd(dtype):
+    return CumProdBlock(dtype)
+
+"""
+/*
+ * |PothosDoc Difference
+ *
+ * Calculate the difference between each value in the stream and the one
+ * before it.
+ *
+ * The last value of each buffer is kept for the next, so the output is
+ * <b>numpy.diff</b> of the whole stream. The stream's first value has no
+ * previous value, so it has no output.
+ *
+ * Corresponding NumPy function: <b>numpy.diff</b>
+ *
+ * |category /NumPy/Arithmetic
+ * |keywords diff difference delta derivative discrete
+ * |factory /numpy/diff(dtype)
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1,cfloat=1)
+ * |default "float64"
+ * |preview disable
+ */
+"""
+def Diff(dtype):
+    return DiffBlock(dtype)
+
+"""
+/*
+ * |PothosDoc Gradient
+ *
+ * Return the gradient of the input stream.
+ *
+ * Each value's gradient is the central difference of its neighbors, divided
+ * by twice the <b>spacing</b>. The first value's is a one-sided difference,
+ * as with <b>numpy.gradient</b>. As each gradient needs the next value, the
+ * output lags the input by one value, and the stream's last value has no
+ * output.
+ *
+ * Corresponding NumPy function: <b>numpy.gradient</b>
+ *
+ * |category /NumPy/Arithmetic
+ * |keywords gradient derivative slope central difference rate
+ * |factory /numpy/gradient(dtype,spacing)
+ * |setter setSpacing(spacing)
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(float=1,cfloat=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param spacing[Spacing] The spacing between input values, such as the sample period.
+ * |widget DoubleSpinBox(minimum=0)
+ * |default 1.0
+ * |preview enable
+ */
+"""
+def Gradient(dtype, spacing):
+    return GradientBlock(dtype, spacing)
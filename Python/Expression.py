@@ -0,0 +1,273 @@
+# Copyright (c) 2019-2020 Nicholas Corgan
+# SPDX-License-Identifier: BSD-3-Clause
+
+from .BaseBlock import *
+
+from . import ThreadPool
+from . import Utility
+
+import Pothos
+
+import ast
+import numpy
+
+# Element-wise functions that can be used in expressions, named as in the
+# generated block catalog
+ExpressionFuncs = dict(
+    # Arithmetic
+    add=numpy.add,
+    multiply=numpy.multiply,
+    subtract=numpy.subtract,
+    divide=numpy.divide,
+    true_divide=numpy.true_divide,
+    floor_divide=numpy.floor_divide,
+    remainder=numpy.remainder,
+    mod=numpy.mod,
+    fmod=numpy.fmod,
+    power=numpy.power,
+    reciprocal=numpy.reciprocal,
+    sqrt=numpy.sqrt,
+    cbrt=numpy.cbrt,
+    square=numpy.square,
+    absolute=numpy.absolute,
+    abs=numpy.absolute,
+    fabs=numpy.fabs,
+    negative=numpy.negative,
+    positive=numpy.positive,
+    copysign=numpy.copysign,
+    maximum=numpy.maximum,
+    minimum=numpy.minimum,
+    clip=numpy.clip,
+
+    # Trig
+    sin=numpy.sin,
+    cos=numpy.cos,
+    tan=numpy.tan,
+    arcsin=numpy.arcsin,
+    arccos=numpy.arccos,
+    arctan=numpy.arctan,
+    sinh=numpy.sinh,
+    cosh=numpy.cosh,
+    tanh=numpy.tanh,
+    arcsinh=numpy.arcsinh,
+    arccosh=numpy.arccosh,
+    arctanh=numpy.arctanh,
+    deg2rad=numpy.deg2rad,
+    radians=numpy.radians,
+    rad2deg=numpy.rad2deg,
+    degrees=numpy.degrees,
+
+    # Exponential
+    exp=numpy.exp,
+    expm1=numpy.expm1,
+    exp2=numpy.exp2,
+    log=numpy.log,
+    log10=numpy.log10,
+    log2=numpy.log2,
+    log1p=numpy.log1p,
+    logaddexp=numpy.logaddexp,
+    logaddexp2=numpy.logaddexp2,
+
+    # Rounding
+    rint=numpy.rint,
+    ceil=numpy.ceil,
+    floor=numpy.floor,
+    trunc=numpy.trunc,
+    fix=numpy.fix,
+    around=numpy.around,
+
+    # Binary
+    invert=numpy.invert,
+    bitwise_and=numpy.bitwise_and,
+    bitwise_or=numpy.bitwise_or,
+    bitwise_xor=numpy.bitwise_xor,
+
+    # Complex
+    angle=numpy.angle,
+    real=numpy.real,
+    imag=numpy.imag,
+    conjugate=numpy.conjugate,
+    conj=numpy.conjugate,
+
+    # Special
+    i0=numpy.i0,
+    sinc=numpy.sinc,
+    nan_to_num=numpy.nan_to_num
+)
+
+ExpressionConstants = dict(
+    pi=numpy.pi,
+    e=numpy.e,
+    inf=numpy.inf,
+    nan=numpy.nan
+)
+
+AllowedBinOps = (ast.Add, ast.Sub, ast.Mult, ast.Div, ast.FloorDiv, ast.Mod, ast.Pow, ast.BitAnd, ast.BitOr, ast.BitXor)
+AllowedUnaryOps = (ast.UAdd, ast.USub, ast.Invert)
+
+# Parses the given expression and checks that it only uses arithmetic,
+# numbers, the given names, and the functions above. Returns the compiled
+# expression.
+def compileExpression(expression, names):
+    try:
+        tree = ast.parse(expression.strip(), mode="eval")
+    except SyntaxError as e:
+        raise ValueError("Invalid expression \"{0}\": {1}".format(expression, e.msg))
+
+    for node in ast.walk(tree):
+        if isinstance(node, (ast.Expression, ast.Load, ast.operator, ast.unaryop)):
+            continue
+        elif isinstance(node, ast.BinOp):
+            if not isinstance(node.op, AllowedBinOps):
+                raise ValueError("Unsupported operator: {0}".format(type(node.op).__name__))
+        elif isinstance(node, ast.UnaryOp):
+            if not isinstance(node.op, AllowedUnaryOps):
+                raise ValueError("Unsupported operator: {0}".format(type(node.op).__name__))
+        elif isinstance(node, ast.Call):
+            if (not isinstance(node.func, ast.Name)) or (node.func.id not in ExpressionFuncs):
+                raise ValueError("Unsupported function: {0}".format(ast.dump(node.func)))
+            if node.keywords:
+                raise ValueError("Keyword arguments are not supported.")
+        elif isinstance(node, ast.Name):
+            if (node.id not in names) and (node.id not in ExpressionFuncs):
+                raise ValueError("Unknown name: {0}".format(node.id))
+        elif isinstance(node, ast.Constant):
+            if (type(node.value) not in [int, float, complex]):
+                raise ValueError("Unsupported constant: {0}".format(repr(node.value)))
+        else:
+            raise ValueError("Unsupported syntax: {0}".format(type(node).__name__))
+
+    return compile(tree, "<expression>", "eval")
+
+class ExpressionBlock(BaseBlock):
+    def __init__(self, dtype, nchans, expression):
+        if nchans < 1:
+            raise ValueError("nchans must be at least 1.")
+
+        dtype = Utility.toDType(dtype)
+        dtypeArgs = dict(supportInt=True, supportUInt=True, supportFloat=True, supportComplex=True, supportVector=True)
+        BaseBlock.__init__(self, "/numpy/expression", None, dtype, dtype, dtypeArgs, dtypeArgs, list(), dict(), useDType=False)
+
+        self.__nchans = nchans
+        self.__names = ["x"] + ["x{0}".format(chan) for chan in range(nchans)]
+
+        # Constants and functions, which the input names are added to for
+        # each tile
+        self.__namespace = dict(ExpressionFuncs)
+        self.__namespace.update(ExpressionConstants)
+        if self.numpyInputDType.kind in "fc":
+            self.__namespace["eps"] = numpy.finfo(self.numpyInputDType).eps
+        else:
+            self.__namespace["eps"] = 0
+        self.__namespace["__builtins__"] = dict()
+
+        self.setExpression(expression)
+
+        for chan in range(nchans):
+            self.setupInput(chan, dtype)
+        self.setupOutput(0, dtype)
+
+        self.registerProbe("expression")
+        self.registerProbe("numThreads")
+
+    def nchans(self):
+        return self.__nchans
+
+    def expression(self):
+        return self.__expression
+
+    def setExpression(self, expression):
+        names = self.__names + list(ExpressionConstants.keys()) + ["eps"]
+        self.__code = compileExpression(expression, names)
+        self.__expression = expression
+
+    def __evaluateTiles(self, inBufs, outBuf, start, stop):
+        namespace = dict(self.__namespace)
+        for tileStart in range(start, stop, Utility.ElementwiseTileElements):
+            tileStop = min(tileStart + Utility.ElementwiseTileElements, stop)
+
+            namespace["x"] = inBufs[0][tileStart:tileStop]
+            for (chan, inBuf) in enumerate(inBufs):
+                namespace["x{0}".format(chan)] = inBuf[tileStart:tileStop]
+
+            # Assignment broadcasts constant expressions and converts the
+            # result to the output type.
+            outBuf[tileStart:tileStop] = eval(self.__code, namespace)
+
+    def work(self):
+        elems = self.workInfo().minAllInElements
+        if 0 == elems:
+            return
+
+        (outBuf, isPosted) = self.getTiledOutputBuffer(elems)
+        elems = len(outBuf)
+        if 0 == elems:
+            return
+
+        inBufs = [port.buffer()[:elems] for port in self.inputs()]
+
+        def processTile(start, stop, worker):
+            self.__evaluateTiles(inBufs, outBuf, start, stop)
+
+        ThreadPool.runTiles(processTile, elems, self.numThreads())
+
+        for port in self.inputs():
+            port.consume(elems)
+        self.finishTiledOutput(outBuf, isPosted)
+
+#
+# Factory exposed to C++ layer
+#
+
+"""
+/*
+ * |PothosDoc Expression
+ *
+ * Evaluate an element-wise expression over the inputs, in a single block.
+ *
+ * Inputs are referred to as <b>x0</b>, <b>x1</b>, and so on, and <b>x</b> is
+ * the same as <b>x0</b>. Expressions can use arithmetic operators, numbers,
+ * the constants <b>pi</b>, <b>e</b>, <b>inf</b>, <b>nan</b> and <b>eps</b>
+ * (the machine epsilon of the block's type), and the element-wise functions
+ * of the other NumPy blocks, named the same way. For example:
+ *
+ * <b>10*log10(abs(x)**2 + eps)</b>
+ *
+ * The expression is compiled once, and each buffer is evaluated in tiles
+ * small enough that intermediate results stay in the CPU cache, rather than
+ * each step making its own pass over the whole buffer as a chain of blocks
+ * would.
+ *
+ * Input buffers larger than a tile (8192 elements) can be split across the
+ * shared thread pool. The default 8 KiB buffers are never that large, so
+ * threads only help downstream of blocks that post larger buffers.
+ *
+ * |category /NumPy/Arithmetic
+ * |keywords expression formula equation fused math arithmetic
+ * |factory /numpy/expression(dtype,nchans,expression)
+ * |setter setExpression(expression)
+ * |setter setNumThreads(numThreads)
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1,cfloat=1,dim=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param nchans[Num Inputs] The number of inputs.
+ * |widget SpinBox(minimum=1)
+ * |default 1
+ * |preview disable
+ *
+ * |param expression[Expression]
+ * |widget StringEntry()
+ * |default "x"
+ * |preview enable
+ *
+ * |param numThreads[Num Threads] The number of threads to evaluate tiles on, or 0 for the global default.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ */
+"""
+def Expression(dtype, nchans, expression):
+    return ExpressionBlock(dtype, nchans, expression)
@@ -2,15 +2,128 @@
 # SPDX-License-Identifier: BSD-3-Clause
 
 from .BaseBlock import *
+from .Window import WindowFuncDict
+from . import ThreadPool
 from . import Utility
 
 import Pothos
 
+import inspect
+import math
 import numpy
 import numpy.fft
 
+# The full spectrum of real input, computed with a real-to-complex transform
+# of half the work. The negative frequencies are the conjugates of the
+# positive ones.
+def realInputFFT(a, axis=-1):
+    numBins = a.shape[axis]
+    half = numpy.moveaxis(numpy.fft.rfft(a, axis=axis), axis, -1)
+    numHalfBins = half.shape[-1]
+
+    out = numpy.empty(half.shape[:-1] + (numBins,), dtype=half.dtype)
+    out[..., :numHalfBins] = half
+    numpy.conjugate(half[..., (numBins - numHalfBins):0:-1], out=out[..., numHalfBins:])
+
+    return numpy.moveaxis(out, -1, axis)
+
+#
+# Large FFTs
+#
+# numpy.fft transforms each frame on one core. Above LargeFFTThreshold bins,
+# fft and ifft are instead split with the four-step algorithm: a length
+# N1*N2 transform becomes N2 transforms of length N1, a twiddle factor
+# multiplication, and N1 transforms of length N2. Each step's transforms are
+# independent, so they're spread over the shared thread pool.
+#
+
+LargeFFTThreshold = 2**18
+
+# NumPy 2.0+ can write FFT results into an existing array.
+FFTSupportsOut = ("out" in inspect.signature(numpy.fft.fft).parameters)
+
+# Returns (N1, N2) with N1 as close to sqrt(N) as possible, or None if N is
+# prime.
+def getFourStepFactors(N):
+    for N1 in range(math.isqrt(N), 1, -1):
+        if 0 == (N % N1):
+            return (N1, N // N1)
+
+    return None
+
+# Real input is transformed as complex, as the rows of a four-step transform
+# aren't real.
+FourStepFuncs = {
+    numpy.fft.fft: numpy.fft.fft,
+    numpy.fft.ifft: numpy.fft.ifft,
+    realInputFFT: numpy.fft.fft
+}
+
+class FourStepFFT(object):
+    def __init__(self, func, numBins, numpyDType):
+        if func not in FourStepFuncs:
+            raise ValueError("The four-step algorithm only supports fft and ifft.")
+        func = FourStepFuncs[func]
+
+        factors = getFourStepFactors(numBins)
+        if factors is None:
+            raise ValueError("The four-step algorithm requires a composite numBins.")
+
+        self.__func = func
+        (self.__N1, self.__N2) = factors
+
+        # Element [n1, n2] of the input is x[(N2 * n1) + n2], and element
+        # [k1, k2] of the output is X[k1 + (N1 * k2)].
+        sign = -1.0 if (func is numpy.fft.fft) else 1.0
+        (k1, n2) = numpy.meshgrid(numpy.arange(self.__N1), numpy.arange(self.__N2), indexing="ij")
+        self.__twiddles = numpy.exp((sign * 2j * numpy.pi / numBins) * ((k1 * n2) % numBins)).astype(numpyDType)
+
+        # Reused across calls, so large transforms don't allocate.
+        self.__work = Utility.alignedEmpty((self.__N1, self.__N2), numpyDType)
+
+    # Transforms one frame into the given output array.
+    def __call__(self, frame, out, numThreads):
+        N1 = self.__N1
+        N2 = self.__N2
+        frame = frame.reshape((N1, N2))
+        outView = out.reshape((N2, N1))
+
+        # Columns: length N1 transforms, then the twiddle factors
+        def processColumns(start, stop, worker):
+            if FFTSupportsOut:
+                self.__func(frame[:, start:stop], axis=0, out=self.__work[:, start:stop])
+            else:
+                self.__work[:, start:stop] = self.__func(frame[:, start:stop], axis=0)
+
+            self.__work[:, start:stop] *= self.__twiddles[:, start:stop]
+
+        # Rows: length N2 transforms, written transposed into the output
+        def processRows(start, stop, worker):
+            if FFTSupportsOut:
+                self.__func(self.__work[start:stop, :], axis=1, out=outView[:, start:stop].T)
+            else:
+                outView[:, start:stop] = self.__func(self.__work[start:stop, :], axis=1).T
+
+        ThreadPool.runTiles(processColumns, N2, numThreads, max(1, -(-N2 // numThreads)))
+        ThreadPool.runTiles(processRows, N1, numThreads, max(1, -(-N1 // numThreads)))
+
 class FFTClass(BaseBlock):
     def __init__(self, blockPath, func, inputDType, outputDType, inputDTypeArgs, outputDTypeArgs, numBins, warnIfSuboptimal=False):
+        inputDType = Utility.toDType(inputDType)
+        outputDType = Utility.toDType(outputDType)
+
+        # With a vector DType, each element is already a frame, so the whole
+        # buffer can be transformed at once.
+        self.__isVector = (inputDType.dimension() > 1)
+        if self.__isVector:
+            if inputDType.dimension() != numBins:
+                raise ValueError("numBins ({0}) must match the input DType's dimension ({1}).".format(numBins, inputDType.dimension()))
+
+            numOutputBins = len(func(numpy.zeros(numBins)))
+            outputDType = Utility.DType(outputDType.name(), numOutputBins)
+
+        inputDTypeArgs = dict(inputDTypeArgs, supportVector=True)
+        outputDTypeArgs = dict(outputDTypeArgs, supportVector=True)
         BaseBlock.__init__(self, blockPath, func, inputDType, outputDType, inputDTypeArgs, outputDTypeArgs, list(), dict())
 
         # The FFT algorithm is fastest for powers of 2.
@@ -21,16 +134,38 @@ class FFTClass(BaseBlock):
 
         self.__numBins = numBins
 
-        self.setupInput(0, inputDType)
-        self.setupOutput(0, outputDType)
-        self.input(0).setReserve(numBins)
+        # Created on first use, as its work buffers are as large as a frame.
+        self.__fourStep = None
+        self.__supportsFourStep = (func in FourStepFuncs) and \
+                                  (numBins >= LargeFFTThreshold) and \
+                                  (getFourStepFactors(numBins) is not None)
+
+        self.setupInput(0, self.inputDType)
+        self.setupOutput(0, self.outputDType)
+        if not self.__isVector:
+            self.input(0).setReserve(numBins)
 
         self.registerProbe("numBins")
 
     def numBins(self):
         return self.__numBins
 
+    # Whether frames are transformed with the multi-threaded four-step
+    # algorithm, which needs more than one thread to be worthwhile
+    def usesFourStep(self):
+        return self.__supportsFourStep and (self.numThreads() > 1)
+
+    def __transformFrame(self, frame, out):
+        if self.__fourStep is None:
+            self.__fourStep = FourStepFFT(self.func, self.__numBins, self.numpyOutputDType)
+
+        self.__fourStep(frame, out, self.numThreads())
+
     def work(self):
+        if self.__isVector:
+            self.workVector()
+            return
+
         elems = self.workInfo().minAllElements
         if 0 == elems:
             return
@@ -38,11 +173,35 @@ class FFTClass(BaseBlock):
         in0 = self.input(0)
         out0 = self.output(0)
 
-        output = self.func(in0.buffer()).astype(self.numpyOutputDType)
+        frame = self.toNumPyInput(in0.buffer()[:self.__numBins])
+        if self.usesFourStep():
+            output = numpy.empty(self.__numBins, dtype=self.numpyOutputDType)
+            self.__transformFrame(frame, output)
+        else:
+            output = self.func(frame).astype(self.numpyOutputDType)
 
         in0.consume(self.__numBins)
         out0.postBuffer(output)
 
+    def workVector(self):
+        elems = self.workInfo().minAllElements
+        if 0 == elems:
+            return
+
+        in0 = self.input(0).buffer()
+        out0 = self.output(0).buffer()
+        N = min(len(in0), len(out0))
+
+        # The buffers are (frames, numBins) arrays.
+        if self.usesFourStep():
+            for frame in range(N):
+                self.__transformFrame(self.toNumPyInput(in0[frame]), out0[frame])
+        else:
+            out0[:N] = self.func(in0[:N], axis=1)
+
+        self.input(0).consume(N)
+        self.output(0).produce(N)
+
 #
 # Factories exposed to C++ layer
 #
@@ -61,35 +220,68 @@ class FFTClass(BaseBlock):
  * terms. The symmetry is highest when n is a power of 2, and the transform is
  * therefore most efficient for these sizes.
  *
+ * Real input is transformed with a real-to-complex transform, which takes
+ * about half the work. By default, the negative frequencies are then filled
+ * in from the positive ones, as the spectrum of real input is Hermitian. With
+ * <b>oneSided</b>, only the <b>numBins/2 + 1</b> non-negative frequencies are
+ * output, as with <b>/numpy/fft/rfft</b>, halving the output.
+ *
+ * Transforms of at least 2<sup>18</sup> bins are split across threads when
+ * <b>setNumThreads</b> is given more than one thread.
+ *
  * Corresponding NumPy function: <b>numpy.fft.fft</b>
  *
  * |category /NumPy/FFT
  * |keywords fft discrete fast fourier transform
- * |factory /numpy/fft/fft(dtype,numBins)
+ * |factory /numpy/fft/fft(dtype,numBins,oneSided)
+ * |setter setBackendNumThreads(backendNumThreads)
  *
  * |param dtype[Input Data Type] The block data type.
- * |widget DTypeChooser(float=1,cfloat=1)
+ * |widget DTypeChooser(float=1,cfloat=1,cint=1,dim=1)
  * |default "complex_float64"
  * |preview disable
  *
- * |param numBins[Num FFT Bins]
+ * |param numBins[Num FFT Bins] For vector data types, this must match the dimension, and each
+ * element is transformed as one frame.
  * |default 1024
  * |option 512
  * |option 1024
  * |option 2048
  * |option 4096
  * |widget ComboBox(editable=true)
+ *
+ * |param oneSided[One-Sided?] For real input, whether to only output the non-negative frequencies.
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default false
+ * |preview enable
+ *
+ * |param backendNumThreads[Backend Num Threads] The maximum number of threads NumPy's FFT backend may
+ * use while this block exists, or 0 for no limit of its own. This only has an effect when NumPy's FFTs
+ * are backed by a threaded library, such as MKL, and requires the threadpoolctl module. The thread
+ * count is process-wide, so every block uses the smallest of the global limit and all blocks' limits.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview disable
  */
 """
-def FFT(dtype, numBins):
+def FFT(dtype, numBins, oneSided=False):
     dtype = Utility.toDType(dtype)
 
+    isRealInput = not (dtype.isComplex() or Utility.isComplexIntDType(dtype))
+    if oneSided and not isRealInput:
+        raise ValueError("oneSided is only supported for real input.")
+
+    if isRealInput:
+        func = numpy.fft.rfft if oneSided else realInputFFT
+    else:
+        func = numpy.fft.fft
+
     return FFTClass(
                "/numpy/fft/fft",
-               numpy.fft.fft,
+               func,
                dtype,
-               Utility.dtypeToComplex(dtype),
-               dict(supportFloat=True, supportComplex=True),
+               Utility.dtypeToComplexFloat(dtype),
+               dict(supportFloat=True, supportComplex=True, supportCInt=True),
                dict(supportComplex=True),
                numBins,
                warnIfSuboptimal=True)
@@ -116,24 +308,37 @@ def FFT(dtype, numBins):
  * values at the positive and negative Nyquist frequencies, as the two are
  * aliased together.
  *
+ * Transforms of at least 2<sup>18</sup> bins are split across threads when
+ * <b>setNumThreads</b> is given more than one thread.
+ *
  * Corresponding NumPy function: <b>numpy.fft.ifft</b>
  *
  * |category /NumPy/FFT
  * |keywords fft ifft inverse discrete fast fourier transform
  * |factory /numpy/fft/ifft(dtype,numBins)
+ * |setter setBackendNumThreads(backendNumThreads)
  *
  * |param dtype[Input Data Type] The block data type.
- * |widget DTypeChooser(float=1,cfloat=1)
+ * |widget DTypeChooser(float=1,cfloat=1,cint=1,dim=1)
  * |default "complex_float64"
  * |preview disable
  *
- * |param numBins[Num FFT Bins]
+ * |param numBins[Num FFT Bins] For vector data types, this must match the dimension, and each
+ * element is transformed as one frame.
  * |default 1024
  * |option 512
  * |option 1024
  * |option 2048
  * |option 4096
  * |widget ComboBox(editable=true)
+ *
+ * |param backendNumThreads[Backend Num Threads] The maximum number of threads NumPy's FFT backend may
+ * use while this block exists, or 0 for no limit of its own. This only has an effect when NumPy's FFTs
+ * are backed by a threaded library, such as MKL, and requires the threadpoolctl module. The thread
+ * count is process-wide, so every block uses the smallest of the global limit and all blocks' limits.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview disable
  */
 """
 def IFFT(dtype, numBins):
@@ -143,8 +348,8 @@ def IFFT(dtype, numBins):
                "/numpy/fft/ifft",
                numpy.fft.ifft,
                dtype,
-               Utility.dtypeToComplex(dtype),
-               dict(supportFloat=True, supportComplex=True),
+               Utility.dtypeToComplexFloat(dtype),
+               dict(supportFloat=True, supportComplex=True, supportCInt=True),
                dict(supportComplex=True),
                numBins)
 
@@ -182,19 +387,29 @@ def IFFT(dtype, numBins):
  * |category /NumPy/FFT
  * |keywords fft rfft real discrete fast fourier transform
  * |factory /numpy/fft/rfft(dtype,numBins)
+ * |setter setBackendNumThreads(backendNumThreads)
  *
  * |param dtype[Input Data Type] The block data type.
- * |widget DTypeChooser(float=1)
+ * |widget DTypeChooser(float=1,dim=1)
  * |default "float64"
  * |preview disable
  *
- * |param numBins[Num FFT Bins]
+ * |param numBins[Num FFT Bins] For vector data types, this must match the dimension, and each
+ * element is transformed as one frame.
  * |default 1024
  * |option 512
  * |option 1024
  * |option 2048
  * |option 4096
  * |widget ComboBox(editable=true)
+ *
+ * |param backendNumThreads[Backend Num Threads] The maximum number of threads NumPy's FFT backend may
+ * use while this block exists, or 0 for no limit of its own. This only has an effect when NumPy's FFTs
+ * are backed by a threaded library, such as MKL, and requires the threadpoolctl module. The thread
+ * count is process-wide, so every block uses the smallest of the global limit and all blocks' limits.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview disable
  */
 """
 def RFFT(dtype, numBins):
@@ -230,19 +445,29 @@ def RFFT(dtype, numBins):
  * |category /NumPy/FFT
  * |keywords fft rfft rifft real inverse discrete fast fourier transform
  * |factory /numpy/fft/irfft(dtype,numBins)
+ * |setter setBackendNumThreads(backendNumThreads)
  *
  * |param dtype[Input Data Type] The block data type.
- * |widget DTypeChooser(float=1,cfloat=1)
+ * |widget DTypeChooser(float=1,cfloat=1,dim=1)
  * |default "complex_float64"
  * |preview disable
  *
- * |param numBins[Num FFT Bins]
+ * |param numBins[Num FFT Bins] For vector data types, this must match the dimension, and each
+ * element is transformed as one frame.
  * |default 1024
  * |option 512
  * |option 1024
  * |option 2048
  * |option 4096
  * |widget ComboBox(editable=true)
+ *
+ * |param backendNumThreads[Backend Num Threads] The maximum number of threads NumPy's FFT backend may
+ * use while this block exists, or 0 for no limit of its own. This only has an effect when NumPy's FFTs
+ * are backed by a threaded library, such as MKL, and requires the threadpoolctl module. The thread
+ * count is process-wide, so every block uses the smallest of the global limit and all blocks' limits.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview disable
  */
 """
 def IRFFT(dtype, numBins):
@@ -270,19 +495,29 @@ def IRFFT(dtype, numBins):
  * |category /NumPy/FFT
  * |keywords fft hfft hermetian discrete fast fourier transform
  * |factory /numpy/fft/hfft(dtype,numBins)
+ * |setter setBackendNumThreads(backendNumThreads)
  *
  * |param dtype[Input Data Type] The block data type.
- * |widget DTypeChooser(float=1,cfloat=1)
+ * |widget DTypeChooser(float=1,cfloat=1,dim=1)
  * |default "complex_float64"
  * |preview disable
  *
- * |param numBins[Num FFT Bins]
+ * |param numBins[Num FFT Bins] For vector data types, this must match the dimension, and each
+ * element is transformed as one frame.
  * |default 1024
  * |option 512
  * |option 1024
  * |option 2048
  * |option 4096
  * |widget ComboBox(editable=true)
+ *
+ * |param backendNumThreads[Backend Num Threads] The maximum number of threads NumPy's FFT backend may
+ * use while this block exists, or 0 for no limit of its own. This only has an effect when NumPy's FFTs
+ * are backed by a threaded library, such as MKL, and requires the threadpoolctl module. The thread
+ * count is process-wide, so every block uses the smallest of the global limit and all blocks' limits.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview disable
  */
 """
 def HFFT(dtype, numBins):
@@ -310,19 +545,29 @@ def HFFT(dtype, numBins):
  * |category /NumPy/FFT
  * |keywords fft hfft ihfft inverse hermetian discrete fast fourier transform
  * |factory /numpy/fft/ihfft(dtype,numBins)
+ * |setter setBackendNumThreads(backendNumThreads)
  *
  * |param dtype[Input Data Type] The block data type.
- * |widget DTypeChooser(float=1)
+ * |widget DTypeChooser(float=1,dim=1)
  * |default "float64"
  * |preview disable
  *
- * |param numBins[Num FFT Bins]
+ * |param numBins[Num FFT Bins] For vector data types, this must match the dimension, and each
+ * element is transformed as one frame.
  * |default 1024
  * |option 512
  * |option 1024
  * |option 2048
  * |option 4096
  * |widget ComboBox(editable=true)
+ *
+ * |param backendNumThreads[Backend Num Threads] The maximum number of threads NumPy's FFT backend may
+ * use while this block exists, or 0 for no limit of its own. This only has an effect when NumPy's FFTs
+ * are backed by a threaded library, such as MKL, and requires the threadpoolctl module. The thread
+ * count is process-wide, so every block uses the smallest of the global limit and all blocks' limits.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview disable
  */
 """
 def IHFFT(dtype, numBins):
@@ -336,3 +581,694 @@ def IHFFT(dtype, numBins):
                dict(supportFloat=True),
                dict(supportComplex=True),
                numBins)
+
+#
+# Power spectrum
+#
+
+SpectrumWindowFuncDict = dict(WindowFuncDict, RECTANGULAR=numpy.ones)
+
+def getSpectrumWindow(windowType, numBins, kaiserBeta):
+    windowFunc = SpectrumWindowFuncDict[windowType]
+    if windowType == "KAISER":
+        return windowFunc(numBins, kaiserBeta)
+
+    return windowFunc(numBins)
+
+# Computes the power spectrum of each frame and averages every numAverages
+# frames into one output frame, replacing an FFT -> absolute -> square ->
+# log10 -> multiply chain and a separate averaging stage.
+class PowerSpectrumBlock(FFTClass):
+    def __init__(self, dtype, numBins, windowType, numAverages, averaging, decibels):
+        dtype = Utility.toDType(dtype)
+
+        # Real input only needs the non-negative frequencies.
+        func = numpy.fft.fft if (dtype.isComplex() or Utility.isComplexIntDType(dtype)) else numpy.fft.rfft
+        outputDType = Utility.dtypeToScalar(Utility.dtypeToComplexFloat(dtype))
+
+        FFTClass.__init__(
+            self,
+            "/numpy/fft/power_spectrum",
+            func,
+            dtype,
+            outputDType,
+            dict(supportFloat=True, supportComplex=True, supportCInt=True),
+            dict(supportFloat=True),
+            numBins)
+
+        self.__numOutputBins = len(func(numpy.zeros(numBins)))
+        self.__kaiserBeta = 0.0
+        self.__windowType = None
+        self.__numAverages = 1
+        self.__averaging = None
+
+        self.setWindowType(windowType)
+        self.setNumAverages(numAverages)
+        self.setAveraging(averaging)
+        self.setDecibels(decibels)
+
+        self.registerProbe("windowType")
+        self.registerProbe("kaiserBeta")
+        self.registerProbe("numAverages")
+        self.registerProbe("averaging")
+        self.registerProbe("decibels")
+
+    def windowType(self):
+        return self.__windowType
+
+    def setWindowType(self, windowType):
+        if windowType not in SpectrumWindowFuncDict:
+            raise ValueError("Invalid window type: {0}".format(windowType))
+
+        self.__windowType = windowType
+        self.__refreshWindow()
+
+    def kaiserBeta(self):
+        return self.__kaiserBeta
+
+    def setKaiserBeta(self, kaiserBeta):
+        self.__kaiserBeta = kaiserBeta
+        self.__refreshWindow()
+
+    def numAverages(self):
+        return self.__numAverages
+
+    def setNumAverages(self, numAverages):
+        if numAverages < 1:
+            raise ValueError("numAverages must be at least 1.")
+
+        self.__numAverages = numAverages
+        self.__reset()
+
+    def averaging(self):
+        return self.__averaging
+
+    def setAveraging(self, averaging):
+        if averaging not in ["LINEAR", "EXPONENTIAL"]:
+            raise ValueError("Invalid averaging: {0}. Valid values: LINEAR, EXPONENTIAL".format(averaging))
+
+        self.__averaging = averaging
+        self.__reset()
+
+    def decibels(self):
+        return self.__decibels
+
+    def setDecibels(self, decibels):
+        self.__decibels = decibels
+
+    # The window is computed once, and scaled so a complex tone at a bin's
+    # center with amplitude A reads A^2 in that bin.
+    def __refreshWindow(self):
+        window = getSpectrumWindow(self.__windowType, self.numBins(), self.__kaiserBeta)
+        self.__window = (window / numpy.sum(window)).astype(self.numpyOutputDType)
+
+    def __reset(self):
+        self.__average = numpy.zeros(self.__numOutputBins, dtype=self.numpyOutputDType)
+        self.__numAveraged = 0
+        self.__hasAverage = False
+
+    def __getPowers(self, frames):
+        spectra = self.func(frames * self.__window, axis=1)
+        return (spectra.real * spectra.real) + (spectra.imag * spectra.imag)
+
+    # Returns the output frames for the given input frames.
+    def __averageFrames(self, powers):
+        outputs = []
+        if self.__averaging == "LINEAR":
+            start = 0
+            while start < len(powers):
+                stop = min(start + (self.__numAverages - self.__numAveraged), len(powers))
+                self.__average += numpy.sum(powers[start:stop], axis=0)
+                self.__numAveraged += (stop - start)
+                start = stop
+
+                if self.__numAveraged == self.__numAverages:
+                    outputs.append(self.__average / self.__numAverages)
+                    self.__average = numpy.zeros_like(self.__average)
+                    self.__numAveraged = 0
+        else:
+            # The average carries over between output frames, with a time
+            # constant of numAverages frames.
+            alpha = 1.0 / self.__numAverages
+            for power in powers:
+                if self.__hasAverage:
+                    self.__average += alpha * (power - self.__average)
+                else:
+                    self.__average[:] = power
+                    self.__hasAverage = True
+
+                self.__numAveraged += 1
+                if self.__numAveraged == self.__numAverages:
+                    outputs.append(self.__average.copy())
+                    self.__numAveraged = 0
+
+        if not outputs:
+            return None
+
+        outputs = numpy.array(outputs, dtype=self.numpyOutputDType)
+        if self.__decibels:
+            outputs = 10.0 * numpy.log10(numpy.maximum(outputs, numpy.finfo(self.numpyOutputDType).tiny))
+
+        return outputs
+
+    def work(self):
+        if self.inputDimension > 1:
+            self.workVector()
+            return
+
+        elems = self.workInfo().minAllInElements
+        numBins = self.numBins()
+        numFrames = elems // numBins
+        if 0 == numFrames:
+            return
+
+        frames = self.toNumPyInput(self.input(0).buffer()[:numFrames*numBins]).reshape((numFrames, numBins))
+        outputs = self.__averageFrames(self.__getPowers(frames))
+        self.input(0).consume(numFrames*numBins)
+
+        if outputs is not None:
+            self.output(0).postBuffer(outputs.reshape(-1))
+
+    def workVector(self):
+        elems = self.workInfo().minAllElements
+        if 0 == elems:
+            return
+
+        # Each element is a frame. Only take as many frames as there is room
+        # in the output buffer to average.
+        out0 = self.output(0).buffer()
+        numFrames = min(elems, (len(out0) * self.__numAverages) - self.__numAveraged)
+        if numFrames <= 0:
+            return
+
+        frames = self.toNumPyInput(self.input(0).buffer()[:numFrames])
+        outputs = self.__averageFrames(self.__getPowers(frames))
+        self.input(0).consume(numFrames)
+
+        if outputs is not None:
+            out0[:len(outputs)] = outputs
+            self.output(0).produce(len(outputs))
+
+"""
+/*
+ * |PothosDoc Power Spectrum
+ *
+ * Compute the averaged power spectrum of each frame of <b>numBins</b> values,
+ * in a single block. This replaces a chain of FFT, absolute value, squaring,
+ * logarithm and averaging blocks, each of which would make its own pass over
+ * every frame.
+ *
+ * Each frame is windowed with a cached window, scaled so that a complex tone
+ * at a bin's center with amplitude <b>A</b> reads <b>A<sup>2</sup></b>. Every
+ * <b>numAverages</b> input frames, one averaged frame is output:
+ * <ul>
+ * <li><b>LINEAR</b>: the mean of those frames' power spectra.</li>
+ * <li><b>EXPONENTIAL</b>: an exponential moving average with a time constant
+ *     of <b>numAverages</b> frames, which carries over between outputs.</li>
+ * </ul>
+ *
+ * For real inputs, the output has the <b>numBins/2 + 1</b> non-negative
+ * frequencies. For complex inputs, it has all <b>numBins</b> frequencies, in
+ * the same order as <b>/numpy/fft/fft</b>.
+ *
+ * |category /NumPy/FFT
+ * |keywords fft psd power spectrum spectral density average db decibel magnitude
+ * |factory /numpy/fft/power_spectrum(dtype,numBins,windowType,numAverages,averaging,decibels)
+ * |setter setKaiserBeta(beta)
+ * |setter setBackendNumThreads(backendNumThreads)
+ *
+ * |param dtype[Input Data Type] The block data type.
+ * |widget DTypeChooser(float=1,cfloat=1,cint=1,dim=1)
+ * |default "complex_float64"
+ * |preview disable
+ *
+ * |param numBins[Num FFT Bins] For vector data types, this must match the dimension, and each
+ * element is transformed as one frame.
+ * |default 1024
+ * |option 512
+ * |option 1024
+ * |option 2048
+ * |option 4096
+ * |widget ComboBox(editable=true)
+ *
+ * |param windowType[Window Type]
+ * |widget ComboBox(editable=False)
+ * |default "HANNING"
+ * |option [Rectangular] "RECTANGULAR"
+ * |option [Bartlett] "BARTLETT"
+ * |option [Blackman] "BLACKMAN"
+ * |option [Hamming] "HAMMING"
+ * |option [Hanning] "HANNING"
+ * |option [Kaiser] "KAISER"
+ * |preview enable
+ *
+ * |param beta[Beta]
+ * |widget DoubleSpinBox()
+ * |default 0.0
+ * |preview when(enum=windowType, "KAISER")
+ *
+ * |param numAverages[Num Averages] The number of input frames per output frame.
+ * |widget SpinBox(minimum=1)
+ * |default 1
+ * |preview enable
+ *
+ * |param averaging[Averaging]
+ * |widget ComboBox(editable=False)
+ * |default "LINEAR"
+ * |option [Linear] "LINEAR"
+ * |option [Exponential] "EXPONENTIAL"
+ * |preview enable
+ *
+ * |param decibels[Decibels?] Whether to output power in dB (<b>10*log10(power)</b>).
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default true
+ * |preview enable
+ *
+ * |param backendNumThreads[Backend Num Threads] The maximum number of threads NumPy's FFT backend may
+ * use while this block exists, or 0 for no limit of its own. This only has an effect when NumPy's FFTs
+ * are backed by a threaded library, such as MKL, and requires the threadpoolctl module. The thread
+ * count is process-wide, so every block uses the smallest of the global limit and all blocks' limits.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview disable
+ */
+"""
+def PowerSpectrum(dtype, numBins, windowType, numAverages, averaging, decibels):
+    return PowerSpectrumBlock(dtype, numBins, windowType, numAverages, averaging, decibels)
+
+#
+# Segmented spectra (Welch PSD and STFT)
+#
+
+# Splits a stream into overlapping segments of numBins values and transforms
+# every segment available in a work() call at once. Only the overlap between
+# the last segment and the next stays in the input buffer, so memory use
+# depends on the segment size, not the stream length.
+class SegmentedFFTBlock(BaseBlock):
+    def __init__(self, blockPath, dtype, outputScalarDType, outputDTypeArgs, numBins, windowType, overlap):
+        dtype = Utility.toDType(dtype)
+
+        # Real input only needs the non-negative frequencies.
+        self.isComplexInput = dtype.isComplex() or Utility.isComplexIntDType(dtype)
+        func = numpy.fft.fft if self.isComplexInput else numpy.fft.rfft
+
+        if numBins < 1:
+            raise ValueError("numBins must be at least 1.")
+
+        # Each output element is one segment's spectrum.
+        self.numOutputBins = len(func(numpy.zeros(numBins)))
+        outputDType = Utility.DType(Utility.toDType(outputScalarDType).name(), self.numOutputBins)
+
+        BaseBlock.__init__(
+            self,
+            blockPath,
+            func,
+            dtype,
+            outputDType,
+            dict(supportFloat=True, supportComplex=True, supportCInt=True),
+            dict(outputDTypeArgs, supportVector=True),
+            list(),
+            dict(),
+            useDType=False)
+
+        self.__numBins = numBins
+        self.__numpyWindowDType = Utility.dtypeToNumPy(Utility.dtypeToScalar(Utility.dtypeToComplexFloat(dtype)))
+        self.__kaiserBeta = 0.0
+        self.__windowType = None
+        self.__overlap = 0
+
+        self.setupInput(0, self.inputDType)
+        self.setupOutput(0, self.outputDType)
+        self.input(0).setReserve(numBins)
+
+        self.setWindowType(windowType)
+        self.setOverlap(overlap)
+
+        self.registerProbe("numBins")
+        self.registerProbe("windowType")
+        self.registerProbe("kaiserBeta")
+        self.registerProbe("overlap")
+
+    def numBins(self):
+        return self.__numBins
+
+    def windowType(self):
+        return self.__windowType
+
+    def setWindowType(self, windowType):
+        if windowType not in SpectrumWindowFuncDict:
+            raise ValueError("Invalid window type: {0}".format(windowType))
+
+        self.__windowType = windowType
+        self.__refreshWindow()
+
+    def kaiserBeta(self):
+        return self.__kaiserBeta
+
+    def setKaiserBeta(self, kaiserBeta):
+        self.__kaiserBeta = kaiserBeta
+        self.__refreshWindow()
+
+    def overlap(self):
+        return self.__overlap
+
+    def setOverlap(self, overlap):
+        if (overlap < 0) or (overlap >= self.__numBins):
+            raise ValueError("overlap must be in the range [0, numBins).")
+
+        self.__overlap = overlap
+
+    def window(self):
+        return self.__window
+
+    def __refreshWindow(self):
+        self.__window = getSpectrumWindow(self.__windowType, self.__numBins, self.__kaiserBeta).astype(self.__numpyWindowDType)
+        self.windowChanged()
+
+    # Overridden by subclasses that cache values based on the window.
+    def windowChanged(self):
+        pass
+
+    # Returns the most segments that can be processed with the given number
+    # of output elements available.
+    def maxNumSegments(self, numOutputElems):
+        return numOutputElems
+
+    # Returns the output elements for the given segments' spectra, as a
+    # (elements, numOutputBins) array, or None if there are none yet.
+    def processSpectra(self, spectra):
+        raise NotImplementedError()
+
+    def work(self):
+        in0 = self.input(0).buffer()
+        out0 = self.output(0).buffer()
+        if len(in0) < self.__numBins:
+            return
+
+        step = self.__numBins - self.__overlap
+        numSegments = min(((len(in0) - self.__numBins) // step) + 1, self.maxNumSegments(len(out0)))
+        if numSegments <= 0:
+            return
+
+        # View the input as overlapping segments, without copying it.
+        samples = self.toNumPyInput(in0[:((numSegments - 1) * step) + self.__numBins])
+        segments = numpy.lib.stride_tricks.as_strided(
+                       samples,
+                       shape=(numSegments, self.__numBins),
+                       strides=(step * samples.strides[0], samples.strides[0]),
+                       writeable=False)
+
+        outputs = self.processSpectra(self.func(segments * self.__window, axis=1))
+        self.input(0).consume(numSegments * step)
+
+        if outputs is not None:
+            out0[:len(outputs)] = outputs
+            self.output(0).produce(len(outputs))
+
+# Outputs each segment's spectrum, scaled so that a complex tone at a bin's
+# center with amplitude A reads A in that bin.
+class STFTBlock(SegmentedFFTBlock):
+    def __init__(self, dtype, numBins, windowType, overlap):
+        dtype = Utility.toDType(dtype)
+
+        SegmentedFFTBlock.__init__(
+            self,
+            "/numpy/fft/stft",
+            dtype,
+            Utility.dtypeToComplexFloat(dtype),
+            dict(supportComplex=True),
+            numBins,
+            windowType,
+            overlap)
+
+    def windowChanged(self):
+        self.__scale = 1.0 / numpy.sum(self.window())
+
+    def processSpectra(self, spectra):
+        spectra *= self.__scale
+        return spectra
+
+# Outputs the mean of the power spectra of every numSegments segments, as in
+# Welch's method.
+class WelchBlock(SegmentedFFTBlock):
+    def __init__(self, dtype, numBins, windowType, overlap, numSegments, sampRate, scaling):
+        dtype = Utility.toDType(dtype)
+
+        # Set before the window, which these are needed to scale.
+        self.__sampRate = 1.0
+        self.__scaling = "DENSITY"
+
+        SegmentedFFTBlock.__init__(
+            self,
+            "/numpy/fft/welch",
+            dtype,
+            Utility.dtypeToScalar(Utility.dtypeToComplexFloat(dtype)),
+            dict(supportFloat=True),
+            numBins,
+            windowType,
+            overlap)
+
+        self.setNumSegments(numSegments)
+        self.setSampRate(sampRate)
+        self.setScaling(scaling)
+
+        self.registerProbe("numSegments")
+        self.registerProbe("sampRate")
+        self.registerProbe("scaling")
+
+    def numSegments(self):
+        return self.__numSegments
+
+    def setNumSegments(self, numSegments):
+        if numSegments < 1:
+            raise ValueError("numSegments must be at least 1.")
+
+        self.__numSegments = numSegments
+        self.__reset()
+
+    def sampRate(self):
+        return self.__sampRate
+
+    def setSampRate(self, sampRate):
+        if sampRate <= 0:
+            raise ValueError("sampRate must be positive.")
+
+        self.__sampRate = sampRate
+        self.windowChanged()
+
+    def scaling(self):
+        return self.__scaling
+
+    def setScaling(self, scaling):
+        if scaling not in ["DENSITY", "SPECTRUM"]:
+            raise ValueError("Invalid scaling: {0}. Valid values: DENSITY, SPECTRUM".format(scaling))
+
+        self.__scaling = scaling
+        self.windowChanged()
+
+    # The same scaling as scipy.signal.welch: DENSITY gives V^2/Hz, and
+    # SPECTRUM gives V^2. For real input, the negative frequencies' power is added to the positive
+    # ones.
+    def windowChanged(self):
+        window = self.window()
+        if self.__scaling == "DENSITY":
+            scale = 1.0 / (self.__sampRate * numpy.sum(window * window))
+        else:
+            scale = 1.0 / (numpy.sum(window) ** 2)
+
+        self.__scales = numpy.full(self.numOutputBins, scale, dtype=self.numpyOutputDType)
+        if not self.isComplexInput:
+            numBins = len(window)
+            self.__scales[1:(numBins+1)//2] *= 2
+
+    def __reset(self):
+        self.__sum = numpy.zeros(self.numOutputBins, dtype=self.numpyOutputDType)
+        self.__numSummed = 0
+
+    def maxNumSegments(self, numOutputElems):
+        return (numOutputElems * self.__numSegments) - self.__numSummed
+
+    def processSpectra(self, spectra):
+        powers = (spectra.real * spectra.real) + (spectra.imag * spectra.imag)
+
+        outputs = []
+        start = 0
+        while start < len(powers):
+            stop = min(start + (self.__numSegments - self.__numSummed), len(powers))
+            self.__sum += numpy.sum(powers[start:stop], axis=0)
+            self.__numSummed += (stop - start)
+            start = stop
+
+            if self.__numSummed == self.__numSegments:
+                outputs.append(self.__sum * (self.__scales / self.__numSegments))
+                self.__sum = numpy.zeros_like(self.__sum)
+                self.__numSummed = 0
+
+        return numpy.array(outputs, dtype=self.numpyOutputDType) if outputs else None
+
+"""
+/*
+ * |PothosDoc Short-Time Fourier Transform
+ *
+ * Compute the spectra of overlapping segments of a stream, as for a
+ * spectrogram.
+ *
+ * The input is split into segments of <b>numBins</b> values, each starting
+ * <b>numBins - overlap</b> values after the last. Each segment is windowed
+ * and transformed, and its spectrum is output as one vector element, scaled
+ * so that a complex tone at a bin's center with amplitude <b>A</b> reads
+ * <b>A</b>. All segments available are transformed at once.
+ *
+ * For real inputs, each output has the <b>numBins/2 + 1</b> non-negative
+ * frequencies. For complex inputs, it has all <b>numBins</b> frequencies, in
+ * the same order as <b>/numpy/fft/fft</b>.
+ *
+ * |category /NumPy/FFT
+ * |keywords fft stft short time fourier transform spectrogram waterfall segment overlap
+ * |factory /numpy/fft/stft(dtype,numBins,windowType,overlap)
+ * |setter setKaiserBeta(beta)
+ * |setter setBackendNumThreads(backendNumThreads)
+ *
+ * |param dtype[Input Data Type] The block data type.
+ * |widget DTypeChooser(float=1,cfloat=1,cint=1)
+ * |default "complex_float64"
+ * |preview disable
+ *
+ * |param numBins[Num FFT Bins] The number of values in each segment.
+ * |default 1024
+ * |option 512
+ * |option 1024
+ * |option 2048
+ * |option 4096
+ * |widget ComboBox(editable=true)
+ *
+ * |param windowType[Window Type]
+ * |widget ComboBox(editable=False)
+ * |default "HANNING"
+ * |option [Rectangular] "RECTANGULAR"
+ * |option [Bartlett] "BARTLETT"
+ * |option [Blackman] "BLACKMAN"
+ * |option [Hamming] "HAMMING"
+ * |option [Hanning] "HANNING"
+ * |option [Kaiser] "KAISER"
+ * |preview enable
+ *
+ * |param beta[Beta]
+ * |widget DoubleSpinBox()
+ * |default 0.0
+ * |preview when(enum=windowType, "KAISER")
+ *
+ * |param overlap[Overlap] The number of values shared by consecutive segments.
+ * Must be less than <b>numBins</b>.
+ * |widget SpinBox(minimum=0)
+ * |default 512
+ * |preview enable
+ *
+ * |param backendNumThreads[Backend Num Threads] The maximum number of threads NumPy's FFT backend may
+ * use while this block exists, or 0 for no limit of its own. This only has an effect when NumPy's FFTs
+ * are backed by a threaded library, such as MKL, and requires the threadpoolctl module. The thread
+ * count is process-wide, so every block uses the smallest of the global limit and all blocks' limits.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview disable
+ */
+"""
+def STFT(dtype, numBins, windowType, overlap):
+    return STFTBlock(dtype, numBins, windowType, overlap)
+
+"""
+/*
+ * |PothosDoc Welch PSD
+ *
+ * Estimate the power spectral density of a stream with Welch's method.
+ *
+ * The input is split into segments of <b>numBins</b> values, each starting
+ * <b>numBins - overlap</b> values after the last. Each segment is windowed
+ * and its power spectrum computed, and every <b>numSegments</b> segments, their
+ * mean is output as one vector element. All segments available are processed
+ * at once, and only a running sum is kept between calls.
+ *
+ * This uses the same scaling as <b>scipy.signal.welch</b>:
+ * <ul>
+ * <li><b>DENSITY</b>: power spectral density, in V<sup>2</sup>/Hz.</li>
+ * <li><b>SPECTRUM</b>: power spectrum, in V<sup>2</sup>.</li>
+ * </ul>
+ * Its results differ from SciPy's defaults, though. Segments aren't
+ * detrended, and the windows are NumPy's symmetric ones rather than the
+ * periodic ones SciPy uses for spectral analysis.
+ *
+ * For real inputs, each output has the <b>numBins/2 + 1</b> non-negative
+ * frequencies, and includes the power of the matching negative frequencies.
+ * For complex inputs, it has all <b>numBins</b> frequencies, in the same order
+ * as <b>/numpy/fft/fft</b>.
+ *
+ * |category /NumPy/FFT
+ * |keywords fft psd welch power spectral density average segment overlap
+ * |factory /numpy/fft/welch(dtype,numBins,windowType,overlap,numSegments,sampRate,scaling)
+ * |setter setKaiserBeta(beta)
+ * |setter setBackendNumThreads(backendNumThreads)
+ *
+ * |param dtype[Input Data Type] The block data type.
+ * |widget DTypeChooser(float=1,cfloat=1,cint=1)
+ * |default "complex_float64"
+ * |preview disable
+ *
+ * |param numBins[Num FFT Bins] The number of values in each segment.
+ * |default 1024
+ * |option 512
+ * |option 1024
+ * |option 2048
+ * |option 4096
+ * |widget ComboBox(editable=true)
+ *
+ * |param windowType[Window Type]
+ * |widget ComboBox(editable=False)
+ * |default "HANNING"
+ * |option [Rectangular] "RECTANGULAR"
+ * |option [Bartlett] "BARTLETT"
+ * |option [Blackman] "BLACKMAN"
+ * |option [Hamming] "HAMMING"
+ * |option [Hanning] "HANNING"
+ * |option [Kaiser] "KAISER"
+ * |preview enable
+ *
+ * |param beta[Beta]
+ * |widget DoubleSpinBox()
+ * |default 0.0
+ * |preview when(enum=windowType, "KAISER")
+ *
+ * |param overlap[Overlap] The number of values shared by consecutive segments.
+ * Must be less than <b>numBins</b>.
+ * |widget SpinBox(minimum=0)
+ * |default 512
+ * |preview enable
+ *
+ * |param numSegments[Num Segments] The number of segments averaged into each output.
+ * |widget SpinBox(minimum=1)
+ * |default 8
+ * |preview enable
+ *
+ * |param sampRate[Sample Rate] The input's sample rate, used for <b>DENSITY</b> scaling.
+ * |widget DoubleSpinBox(minimum=0)
+ * |default 1.0
+ * |units Hz
+ * |preview when(enum=scaling, "DENSITY")
+ *
+ * |param scaling[Scaling]
+ * |widget ComboBox(editable=False)
+ * |default "DENSITY"
+ * |option [Density] "DENSITY"
+ * |option [Spectrum] "SPECTRUM"
+ * |preview enable
+ *
+ * |param backendNumThreads[Backend Num Threads] The maximum number of threads NumPy's FFT backend may
+ * use while this block exists, or 0 for no limit of its own. This only has an effect when NumPy's FFTs
+ * are backed by a threaded library, such as MKL, and requires the threadpoolctl module. The thread
+ * count is process-wide, so every block uses the smallest of the global limit and all blocks' limits.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview disable
+ */
+"""
+def Welch(dtype, numBins, windowType, overlap, numSegments, sampRate, scaling):
+    return WelchBlock(dtype, numBins, windowType, overlap, numSegments, sampRate, scaling)
@@ -15,6 +15,10 @@ import os
 /*
  * |PothosDoc .npy File Sink
  *
+ * Values are converted to the storage type as they arrive, so storing them
+ * at a lower precision also reduces the memory used before the file is
+ * written.
+ *
  * Corresponding NumPy function: <b>numpy.save</b>
  *
  * |category /NumPy/File IO
@@ -22,6 +26,7 @@ import os
  * |category /Sinks
  * |keywords save numpy binary file IO
  * |factory /numpy/npy_sink(filepath,dtype,nchans,append)
+ * |setter setStorageDType(storageDType)
  *
  * |param filepath[Filepath]
  * |widget FileEntry(mode=save)
@@ -42,6 +47,14 @@ import os
  * |default false
  * |widget ToggleSwitch(on="True",off="False")
  * |preview enable
+ *
+ * |param storageDType[Storage Type] The type values are written to the file as. Storing
+ * floating-point values as <b>float16</b> halves the size of the file, at the cost of precision.
+ * |widget ComboBox(editable=False)
+ * |default ""
+ * |option [Input Type] ""
+ * |option [float16] "float16"
+ * |preview enable
  */
 """
 class NpyFileSink(BaseBlock):
@@ -58,10 +71,13 @@ class NpyFileSink(BaseBlock):
             self.logger.info("The \"nchans\" options is currently unimplemented.")
 
         self.__filepath = filepath
+        self.__storageDType = ""
         self.__buffer = numpy.array([], dtype=self.numpyInputDType)
 
         self.setupInput("0", dtype)
 
+        self.registerProbe("storageDType")
+
     def deactivate(self):
         # The .npy file format is intended to take a single array write,
         # so to do this, we'll just accumulate what the previous block has
@@ -80,6 +96,16 @@ class NpyFileSink(BaseBlock):
     def setAppend(self, append):
         self.logger.info("The \"append\" option is currently unimplemented.")
 
+    def storageDType(self):
+        return self.__storageDType
+
+    def setStorageDType(self, storageDType):
+        numpyStorageDType = Utility.getStorageDType(storageDType, self.numpyInputDType)
+        self.__storageDType = storageDType
+
+        # Anything already received is stored the same way.
+        self.__buffer = self.__buffer.astype(numpyStorageDType)
+
     def work(self):
         if 0 == self.workInfo().minAllInElements:
             return
@@ -87,13 +113,17 @@ class NpyFileSink(BaseBlock):
         in0 = self.input(0).buffer()
         N = len(in0)
 
-        self.__buffer = numpy.concatenate([self.__buffer, in0])
+        self.__buffer = numpy.concatenate([self.__buffer, in0.astype(self.__buffer.dtype, copy=False)])
         self.input(0).consume(N)
 
 """
 /*
  * |PothosDoc .npz File Sink
  *
+ * Values are converted to the storage type as they arrive, so storing them
+ * at a lower precision also reduces the memory used before the file is
+ * written.
+ *
  * Corresponding NumPy functions: <b>numpy.savez</b>, <b>numpy.savez_compressed</b>
  *
  * |category /NumPy/File IO
@@ -101,6 +131,7 @@ class NpyFileSink(BaseBlock):
  * |category /Sinks
  * |keywords save numpy binary file IO
  * |factory /numpy/npz_sink(filepath,key,dtype,nchans,compressed,append)
+ * |setter setStorageDType(storageDType)
  *
  * |param filepath[Filepath]
  * |widget FileEntry(mode=save)
@@ -131,6 +162,14 @@ class NpyFileSink(BaseBlock):
  * |default false
  * |widget ToggleSwitch(on="True",off="False")
  * |preview enable
+ *
+ * |param storageDType[Storage Type] The type values are written to the file as. Storing
+ * floating-point values as <b>float16</b> halves the size of the file, at the cost of precision.
+ * |widget ComboBox(editable=False)
+ * |default ""
+ * |option [Input Type] ""
+ * |option [float16] "float16"
+ * |preview enable
  */
 """
 class SaveZBlock(BaseBlock):
@@ -157,11 +196,14 @@ class SaveZBlock(BaseBlock):
         self.__key = key
         self.__compressed = compressed
         self.__append = append
+        self.__storageDType = ""
         self.__buffer = numpy.array([], dtype=self.numpyInputDType)
         self.__allKeys = list(self.__buffers.keys())
 
         self.setupInput("0", dtype)
 
+        self.registerProbe("storageDType")
+
     def deactivate(self):
         # The .npz file format is intended to take a single array write,
         # so to do this, we'll just accumulate what the previous block has
@@ -193,6 +235,16 @@ class SaveZBlock(BaseBlock):
     def allKeys(self):
         return self.__allKeys
 
+    def storageDType(self):
+        return self.__storageDType
+
+    def setStorageDType(self, storageDType):
+        numpyStorageDType = Utility.getStorageDType(storageDType, self.numpyInputDType)
+        self.__storageDType = storageDType
+
+        # Anything already received is stored the same way.
+        self.__buffer = self.__buffer.astype(numpyStorageDType)
+
     def work(self):
         if 0 == self.workInfo().minAllInElements:
             return
@@ -200,7 +252,7 @@ class SaveZBlock(BaseBlock):
         in0 = self.input(0).buffer()
         N = len(in0)
 
-        self.__buffer = numpy.concatenate([self.__buffer, in0])
+        self.__buffer = numpy.concatenate([self.__buffer, in0.astype(self.__buffer.dtype, copy=False)])
         self.input(0).consume(N)
 
 def NpzFileSink(filepath, key, dtype, nchans, compressed, append):
@@ -8,9 +8,22 @@ from . import Utility
 import Pothos
 
 import numpy
+import numpy.lib.format
 import os
+import queue
+import threading
+import time
+import weakref
+import zipfile
 
 class FileSourceBaseBlock(BaseBlock):
+    # How far ahead of a seek to ask the OS to read in memory-mapped files
+    PrefetchBytes = 4*1024*1024
+
+    # The longest work() waits for a rate-limited sample to be due, so slow
+    # rates don't tie up a scheduler thread shared with other blocks
+    MaxRateSleepSeconds = 0.001
+
     def __init__(self, blockPath, filepath, extension, repeat):
         if not os.path.exists(filepath):
             raise IOError("The given file does not exist: {0}".format(filepath))
@@ -24,21 +37,50 @@ class FileSourceBaseBlock(BaseBlock):
         self.__pos = 0
         self.__repeat = repeat
 
+        self.__start = 0
+        self.__stop = 0
+        self.__rate = 0.0
+        self.__resetRateLimiter()
+
+        self.__cacheBuffers = False
+        self.__cache = None
+        self.__cacheChunks = None
+        self.__cacheChunkElements = 0
+
         self.data = None
         self.__is1D = True
-
-    def validateDataAndSetupOutput(self):
-        if len(self.data.shape) not in [1,2]:
+        self.__numSamples = 0
+
+        self.registerProbe("position")
+        self.registerProbe("playbackStart")
+        self.registerProbe("playbackStop")
+        self.registerProbe("rate")
+        self.registerProbe("cacheBuffers")
+        self.registerSlot("seek")
+
+    def validateDataAndSetupOutput(self, shape=None, numpyDType=None):
+        # Subclasses that don't load self.data up front pass in the array's
+        # shape and type instead.
+        shape = self.data.shape if (shape is None) else shape
+        numpyDType = self.data.dtype if (numpyDType is None) else numpyDType
+
+        if len(shape) not in [1,2]:
             raise RuntimeError("This block only supports 1D or 2D arrays.")
 
-        dtype = Utility.DType(self.data.dtype.name)
+        # Half-precision files are widened as they're read.
+        dtype = Utility.DType(Utility.streamNumPyDType(numpyDType).name)
         dtypeArgs = dict(supportAll=True)
         self.initDTypes(None, dtype, None, dtypeArgs)
 
-        for port in range(self.data.shape[0]):
+        self.__is1D = (1 == len(shape))
+        self.__numSamples = shape[-1]
+
+        numPorts = 1 if self.__is1D else shape[0]
+        for port in range(numPorts):
             self.setupOutput(port, dtype)
 
-        self.__is1D = (1 == len(self.data.shape))
+    def activate(self):
+        self.__resetRateLimiter()
 
     def filepath(self):
         return self.__filepath
@@ -49,36 +91,153 @@ class FileSourceBaseBlock(BaseBlock):
     def setRepeat(self, repeat):
         self.__repeat = repeat
 
-    def getOutputLenAndNewPos(self, data, output):
-        n = min(len(output.buffer()), (len(data) - self.__pos))
-
-        if 0 == n:
+    def numSamples(self):
+        return self.__numSamples
+
+    def position(self):
+        return self.__pos
+
+    # Jump to the given sample index. This doesn't read anything, so it
+    # doesn't depend on the file size.
+    def seek(self, sampleIndex):
+        if (sampleIndex < self.__start) or (sampleIndex >= self.__playbackStop()):
+            raise ValueError("Sample index {0} is outside the playback range [{1}, {2}).".format(
+                                 sampleIndex, self.__start, self.__playbackStop()))
+
+        self.__pos = sampleIndex
+        self.prefetch(sampleIndex)
+
+    def playbackStart(self):
+        return self.__start
+
+    # 0 means the end of the file.
+    def playbackStop(self):
+        return self.__stop
+
+    def setPlaybackRange(self, start, stop):
+        effectiveStop = self.__numSamples if (0 == stop) else stop
+        if (start < 0) or (effectiveStop > self.__numSamples) or (start >= effectiveStop):
+            raise ValueError("Invalid playback range [{0}, {1}) for {2} samples.".format(
+                                 start, stop, self.__numSamples))
+
+        self.__start = start
+        self.__stop = stop
+        self.__cache = None
+        self.seek(start)
+
+    # Samples per second per channel. 0 means no rate limiting.
+    def rate(self):
+        return self.__rate
+
+    def setRate(self, rate):
+        if rate < 0:
+            raise ValueError("Rate must be non-negative.")
+
+        self.__rate = float(rate)
+        self.__resetRateLimiter()
+
+    def cacheBuffers(self):
+        return self.__cacheBuffers
+
+    # When enabled, the playback range is converted to the output type and
+    # loaded into memory once, split into buffers of the output buffer size,
+    # and every pass posts those same buffers instead of copying from the
+    # file. The whole playback range must fit in memory.
+    def setCacheBuffers(self, cacheBuffers):
+        self.__cacheBuffers = cacheBuffers
+        self.__cache = None
+
+    def __buildCache(self, chunkElements):
+        rows = [self.data] if self.__is1D else self.data
+        self.__cache = [numpy.array(row[self.__start:self.__playbackStop()], dtype=self.numpyOutputDType)
+                        for row in rows]
+        self.__cacheChunkElements = max(1, chunkElements)
+        self.__cacheChunks = [[Utility.toBufferChunk(cached[offset:(offset+self.__cacheChunkElements)], self.outputDType)
+                               for offset in range(0, len(cached), self.__cacheChunkElements)]
+                              for cached in self.__cache]
+
+    # Returns what to post for n samples from the cache, starting at the
+    # current position. n is already capped to the end of a cached buffer, so
+    # a partial buffer is only needed after a seek or a rate-limited pass, and
+    # that is copied instead.
+    def __readCache(self, n):
+        offset = self.__pos - self.__start
+        (index, remainder) = divmod(offset, self.__cacheChunkElements)
+        if (0 == remainder) and (n == min(self.__cacheChunkElements, len(self.__cache[0]) - offset)):
+            return [chunks[index] for chunks in self.__cacheChunks]
+
+        return [cached[offset:(offset+n)] for cached in self.__cache]
+
+    # Returns one array per output port, starting at sample index start. These
+    # may be shorter than (stop - start), including empty if no samples are
+    # available yet. Subclasses that don't load self.data can override this.
+    def readSamples(self, start, stop):
+        rows = [self.data] if self.__is1D else self.data
+        return [row[start:stop] for row in rows]
+
+    # Whether the arrays returned by readSamples() are owned by this block
+    # and can be posted directly instead of being copied into the output
+    # buffers.
+    def postsSamples(self):
+        return False
+
+    # Subclasses that don't memory-map the file can override this.
+    def prefetch(self, sampleIndex):
+        prefetchSamples = max(1, self.PrefetchBytes // self.data.dtype.itemsize)
+        Utility.prefetchMemmapRegion(
+            self.data,
+            sampleIndex,
+            min(self.__playbackStop(), sampleIndex + prefetchSamples))
+
+    def __playbackStop(self):
+        return self.__numSamples if (0 == self.__stop) else self.__stop
+
+    def __resetRateLimiter(self):
+        self.__rateStartTime = time.monotonic()
+        self.__numRateSamples = 0
+
+    def __numSamplesDue(self):
+        elapsed = time.monotonic() - self.__rateStartTime
+        return int(elapsed * self.__rate) - self.__numRateSamples
+
+    # Returns None if there is no rate limit. If no samples are due, this
+    # waits briefly for the next one, so at higher rates it can be output in
+    # the same call instead of the next.
+    def __numSamplesAllowedByRate(self):
+        if 0 == self.__rate:
+            return None
+
+        numAllowed = self.__numSamplesDue()
+        if numAllowed <= 0:
+            timeToNextSample = ((self.__numRateSamples + 1) / self.__rate) - (time.monotonic() - self.__rateStartTime)
+            maxSleep = min(self.MaxRateSleepSeconds, self.workInfo().maxTimeoutNs / 1e9)
+            time.sleep(max(0.0, min(timeToNextSample, maxSleep)))
+            numAllowed = self.__numSamplesDue()
+
+        return numAllowed
+
+    def getOutputLenAndNewPos(self, output):
+        stop = self.__playbackStop()
+        n = min(len(output.buffer()), (stop - self.__pos))
+
+        if n <= 0:
             if self.__repeat:
-                self.__pos = 0
-                n = min(len(output.buffer()), (len(data) - self.__pos))
+                self.__pos = self.__start
+                self.prefetch(self.__pos)
+                n = min(len(output.buffer()), (stop - self.__pos))
             else:
                 return (-1, -1)
 
+        numAllowed = self.__numSamplesAllowedByRate()
+        if numAllowed is not None:
+            if numAllowed <= 0:
+                return (-1, -1)
+            n = min(n, numAllowed)
+
         newPos = self.__pos + n
         return n, newPos
 
-    def work1D(self):
-        elems = self.workInfo().minElements
-        if 0 == elems:
-            return
-
-        output = self.output(0)
-
-        n, newPos = self.getOutputLenAndNewPos(self.data, output)
-        if -1 == n:
-            return
-
-        output.buffer()[:n] = self.data[self.__pos:newPos].astype(self.numpyOutputDType)
-        output.produce(n)
-
-        self.__pos = newPos
-
-    def work2D(self):
+    def work(self):
         elems = self.workInfo().minElements
         if 0 == elems:
             return
@@ -87,21 +246,37 @@ class FileSourceBaseBlock(BaseBlock):
 
         # Since NumPy arrays cannot be jagged, it is safe to pass in the
         # first buffer.
-        n, newPos = self.getOutputLenAndNewPos(self.data[0], outputs[0])
+        n, newPos = self.getOutputLenAndNewPos(outputs[0])
         if -1 == n:
             return
 
-        for (data, output) in zip(self.data, outputs):
-            output.buffer()[:n] = data[self.__pos:newPos].astype(self.numpyOutputDType)
-            output.produce(n)
+        if self.__cacheBuffers:
+            if self.__cache is None:
+                self.__buildCache(len(outputs[0].buffer()))
 
-        self.__pos = newPos
-
-    def work(self):
-        if self.__is1D:
-            self.work1D()
+            # Don't post past the end of a cached buffer, so the next pass
+            # starts at the next one.
+            offset = self.__pos - self.__start
+            n = min(n, self.__cacheChunkElements - (offset % self.__cacheChunkElements))
+            channels = self.__readCache(n)
+            postSamples = True
         else:
-            self.work2D()
+            channels = self.readSamples(self.__pos, newPos)
+            postSamples = self.postsSamples()
+            n = len(channels[0])
+
+        if 0 == n:
+            return
+
+        for (data, output) in zip(channels, outputs):
+            if postSamples:
+                output.postBuffer(data)
+            else:
+                output.buffer()[:n] = data
+                output.produce(n)
+
+        self.__pos += n
+        self.__numRateSamples += n
 
 """
 /*
@@ -109,12 +284,21 @@ class FileSourceBaseBlock(BaseBlock):
  *
  * Corresponding NumPy function: <b>numpy.load</b> (with .npy extension)
  *
+ * Playback can be restricted to a region of the file with <b>setPlaybackRange</b>,
+ * and <b>seek</b> jumps to any sample index within that region. When repeating,
+ * playback loops back to the start of the region.
+ *
+ * Arrays stored as <b>float16</b> are output as <b>float32</b>.
+ *
  * |category /NumPy/File IO
  * |category /File IO
  * |category /Sources
  * |keywords load numpy binary file IO
  * |factory /numpy/npy_source(filepath,repeat)
  * |setter setRepeat(repeat)
+ * |setter setPlaybackRange(start, stop)
+ * |setter setRate(rate)
+ * |setter setCacheBuffers(cacheBuffers)
  *
  * |param filepath[Filepath]
  * |widget FileEntry(mode=open)
@@ -125,6 +309,28 @@ class FileSourceBaseBlock(BaseBlock):
  * |widget ToggleSwitch(on="True",off="False")
  * |default false
  * |preview enable
+ *
+ * |param start[Playback Start] The first sample index to play back.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ *
+ * |param stop[Playback Stop] One past the last sample index to play back. 0 plays through the end of the file.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ *
+ * |param rate[Rate] Output samples per second per channel. 0 disables rate limiting.
+ * |units samples/sec
+ * |widget DoubleSpinBox(minimum=0)
+ * |default 0.0
+ * |preview enable
+ *
+ * |param cacheBuffers[Cache Buffers?] Load the playback range into memory once and repost the same buffers on every pass.
+ * Only use this when the playback range fits in memory.
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default false
+ * |preview enable
  */
 """
 class NpyFileSource(FileSourceBaseBlock):
@@ -135,18 +341,197 @@ class NpyFileSource(FileSourceBaseBlock):
         self.data = numpy.load(filepath, "r")
         self.validateDataAndSetupOutput()
 
+#
+# Streaming .npz member decoder
+#
+
+def readArrayHeader(fileobj, version):
+    if (1, 0) == version:
+        return numpy.lib.format.read_array_header_1_0(fileobj)
+    elif (2, 0) == version:
+        return numpy.lib.format.read_array_header_2_0(fileobj)
+    else:
+        # NumPy has no public reader for newer header versions.
+        return numpy.lib.format._read_array_header(fileobj, version)
+
+# Decodes a single array from a .npz file on a background thread, a chunk at a
+# time, into a bounded queue. For compressed archives, this keeps both startup
+# time and memory usage independent of the size of the array.
+#
+# Only arrays whose samples are contiguous in the file can be streamed: 1D
+# arrays and Fortran-ordered 2D arrays, whose per-sample frames interleave
+# all channels.
+class NpzMemberStream(object):
+    ChunkBytes = 1024*1024
+    NumChunks = 4
+
+    def __init__(self, filepath, key):
+        self.__zipFile = zipfile.ZipFile(filepath)
+
+        memberName = key + ".npy"
+        if memberName not in self.__zipFile.namelist():
+            memberName = key
+
+        self.__member = self.__zipFile.open(memberName)
+        version = numpy.lib.format.read_magic(self.__member)
+        (self.shape, self.__fortranOrder, self.dtype) = readArrayHeader(self.__member, version)
+        self.__dataOffset = self.__member.tell()
+
+        self.__frameSize = 1 if (1 == len(self.shape)) else self.shape[0]
+
+        self.__thread = None
+        self.__threadFinalizer = None
+        self.__stopEvent = None
+        self.__chunkQueue = None
+        self.__position = 0
+        self.__chunk = None
+        self.__chunkOffset = 0
+
+    def isStreamable(self):
+        if self.dtype.hasobject or (len(self.shape) not in [1,2]):
+            return False
+
+        return (1 == len(self.shape)) or self.__fortranOrder
+
+    def position(self):
+        return self.__position
+
+    def isRunning(self):
+        return self.__thread is not None
+
+    # Stop any in-progress decode and start decoding at the given sample
+    # index. Seeking inside a compressed member means inflating up to that
+    # point, so this happens on the background thread.
+    def restart(self, sampleIndex):
+        self.stop()
+
+        self.__position = sampleIndex
+        self.__chunk = None
+        self.__chunkOffset = 0
+        self.__stopEvent = threading.Event()
+        self.__chunkQueue = queue.Queue(maxsize=self.NumChunks)
+
+        # The thread doesn't reference this object, so if it's destroyed
+        # without being stopped, the finalizer can stop the thread.
+        self.__thread = threading.Thread(
+                            target=NpzMemberStream.__decode,
+                            args=(self.__member, self.__dataOffset, self.__frameSize, self.dtype,
+                                  self.__stopEvent, self.__chunkQueue, sampleIndex))
+        self.__thread.daemon = True
+        self.__thread.start()
+        self.__threadFinalizer = weakref.finalize(self, NpzMemberStream.__stopThread, self.__stopEvent, self.__thread)
+
+    def stop(self):
+        if self.__thread is None:
+            return
+
+        self.__threadFinalizer()
+        self.__thread = None
+
+    @staticmethod
+    def __stopThread(stopEvent, thread):
+        stopEvent.set()
+        thread.join()
+
+    def close(self):
+        self.stop()
+        self.__member.close()
+        self.__zipFile.close()
+
+    # Returns one array per channel, with up to (stop - start) samples. If
+    # the next chunk isn't ready within the timeout, the arrays are empty.
+    def read(self, start, stop, timeout):
+        if (not self.isRunning()) or (start != self.__position):
+            self.restart(start)
+
+        if (self.__chunk is None) or (self.__chunkOffset >= self.__chunk.shape[-1]):
+            try:
+                chunk = self.__chunkQueue.get(timeout=timeout)
+            except queue.Empty:
+                return [numpy.empty(0, Utility.streamNumPyDType(self.dtype))] * self.__frameSize
+
+            if isinstance(chunk, Exception):
+                raise chunk
+            elif chunk is None:
+                raise RuntimeError("Unexpected end of array at sample {0}.".format(self.__position))
+
+            self.__chunk = chunk
+            self.__chunkOffset = 0
+
+        n = min((stop - start), (self.__chunk.shape[-1] - self.__chunkOffset))
+        channels = [row[self.__chunkOffset:(self.__chunkOffset+n)] for row in self.__chunk]
+        self.__chunkOffset += n
+        self.__position += n
+
+        return channels
+
+    @staticmethod
+    def __decode(member, dataOffset, frameSize, dtype, stopEvent, chunkQueue, sampleIndex):
+        frameBytes = frameSize * dtype.itemsize
+        framesPerChunk = max(1, NpzMemberStream.ChunkBytes // frameBytes)
+        streamDType = Utility.streamNumPyDType(dtype)
+
+        try:
+            member.seek(dataOffset + (sampleIndex * frameBytes))
+
+            while not stopEvent.is_set():
+                raw = member.read(framesPerChunk * frameBytes)
+                numFrames = len(raw) // frameBytes
+
+                if 0 == numFrames:
+                    chunk = None
+                else:
+                    # Frames interleave the channels, so convert to one
+                    # contiguous row per channel.
+                    frames = numpy.frombuffer(raw, dtype, count=(numFrames * frameSize))
+                    chunk = numpy.ascontiguousarray(
+                                frames.reshape(numFrames, frameSize).T,
+                                dtype=streamDType)
+
+                if not NpzMemberStream.__put(stopEvent, chunkQueue, chunk) or (chunk is None):
+                    return
+        except Exception as e:
+            NpzMemberStream.__put(stopEvent, chunkQueue, e)
+
+    # Block until there is room in the queue, unless asked to stop.
+    @staticmethod
+    def __put(stopEvent, chunkQueue, item):
+        while not stopEvent.is_set():
+            try:
+                chunkQueue.put(item, timeout=0.1)
+                return True
+            except queue.Full:
+                pass
+
+        return False
+
 """
 /*
  * |PothosDoc .npz File Source
  *
  * Corresponding NumPy function: <b>numpy.load</b> (with .npz extension)
  *
+ * Playback can be restricted to a region of the file with <b>setPlaybackRange</b>,
+ * and <b>seek</b> jumps to any sample index within that region. When repeating,
+ * playback loops back to the start of the region.
+ *
+ * 1D arrays and Fortran-ordered 2D arrays are decoded on a background thread
+ * as they are played back, so even large compressed arrays start immediately
+ * and only a few megabytes are held in memory at a time. Seeking within a
+ * compressed array requires decoding up to the new position. Other arrays are
+ * loaded into memory when the block is created.
+ *
+ * Arrays stored as <b>float16</b> are output as <b>float32</b>.
+ *
  * |category /NumPy/File IO
  * |category /File IO
  * |category /Sources
  * |keywords load numpy binary file IO
  * |factory /numpy/npz_source(filepath,key,repeat)
  * |setter setRepeat(repeat)
+ * |setter setPlaybackRange(start, stop)
+ * |setter setRate(rate)
+ * |setter setCacheBuffers(cacheBuffers)
  *
  * |param filepath[Filepath]
  * |widget FileEntry(mode=open)
@@ -160,6 +545,28 @@ class NpyFileSource(FileSourceBaseBlock):
  * |widget ToggleSwitch(on="True",off="False")
  * |default false
  * |preview enable
+ *
+ * |param start[Playback Start] The first sample index to play back.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ *
+ * |param stop[Playback Stop] One past the last sample index to play back. 0 plays through the end of the file.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ *
+ * |param rate[Rate] Output samples per second per channel. 0 disables rate limiting.
+ * |units samples/sec
+ * |widget DoubleSpinBox(minimum=0)
+ * |default 0.0
+ * |preview enable
+ *
+ * |param cacheBuffers[Cache Buffers?] Load the playback range into memory once and repost the same buffers on every pass.
+ * Only use this when the playback range fits in memory.
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default false
+ * |preview enable
  */
 """
 class NpzFileSource(FileSourceBaseBlock):
@@ -168,13 +575,24 @@ class NpzFileSource(FileSourceBaseBlock):
 
         # Note: "with numpy.load... as" only works in NumPy 1.15 and up
         npzContents = numpy.load(filepath, "r")
-        self.__allKeys = list(dict(npzContents).keys())
+
+        # Don't convert npzContents to a dict, as that decodes every array.
+        self.__allKeys = list(npzContents.files)
 
         if key not in npzContents:
             raise KeyError('Could not find key "{0}".'.format(key))
 
-        self.data = npzContents[key]
-        self.validateDataAndSetupOutput()
+        # Where possible, decode the array on a background thread as it's
+        # played back instead of loading all of it here.
+        self.__stream = NpzMemberStream(filepath, key)
+        if self.__stream.isStreamable():
+            self.validateDataAndSetupOutput(self.__stream.shape, self.__stream.dtype)
+        else:
+            self.__stream.close()
+            self.__stream = None
+
+            self.data = npzContents[key]
+            self.validateDataAndSetupOutput()
 
         self.__key = key
 
@@ -183,3 +601,38 @@ class NpzFileSource(FileSourceBaseBlock):
 
     def allKeys(self):
         return self.__allKeys
+
+    def activate(self):
+        FileSourceBaseBlock.activate(self)
+
+        if (self.__stream is not None) and not self.__stream.isRunning():
+            self.__stream.restart(self.position())
+
+    def deactivate(self):
+        if self.__stream is not None:
+            self.__stream.stop()
+
+    # Cached playback needs the whole array, so stop streaming and load it.
+    def setCacheBuffers(self, cacheBuffers):
+        if cacheBuffers and (self.__stream is not None):
+            self.__stream.close()
+            self.__stream = None
+
+            self.data = numpy.load(self.filepath(), "r")[self.__key]
+
+        FileSourceBaseBlock.setCacheBuffers(self, cacheBuffers)
+
+    def readSamples(self, start, stop):
+        if self.__stream is None:
+            return FileSourceBaseBlock.readSamples(self, start, stop)
+
+        return self.__stream.read(start, stop, self.workInfo().maxTimeoutNs / 1e9)
+
+    def postsSamples(self):
+        return self.__stream is not None
+
+    def prefetch(self, sampleIndex):
+        if self.__stream is None:
+            FileSourceBaseBlock.prefetch(self, sampleIndex)
+        elif self.__stream.position() != sampleIndex:
+            self.__stream.restart(sampleIndex)
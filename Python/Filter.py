@@ -0,0 +1,428 @@
+# Copyright (c) 2019-2020 Nicholas Corgan
+# SPDX-License-Identifier: BSD-3-Clause
+
+from .BaseBlock import *
+from . import Utility
+
+import Pothos
+
+import math
+import numpy
+import numpy.fft
+
+# Returns taps as a (phases, numPhases) array, in which row p holds taps
+# [p*numPhases, (p+1)*numPhases). Taps are zero-padded to a multiple of
+# numPhases.
+def getPolyphaseTaps(taps, numPhases, numpyDType):
+    numRows = max(1, -(-len(taps) // numPhases))
+    padded = numpy.zeros(numRows * numPhases, dtype=numpyDType)
+    padded[:len(taps)] = taps
+
+    return padded.reshape((numRows, numPhases))
+
+# A windowed-sinc low-pass filter with a cutoff of half of 1/decimation of the
+# sample rate and unity gain at DC.
+def getDefaultPrototypeTaps(decimation, tapsPerPhase=8):
+    numTaps = decimation * tapsPerPhase
+    n = numpy.arange(numTaps) - ((numTaps - 1) / 2.0)
+    taps = numpy.sinc(n / decimation) * numpy.hamming(numTaps)
+
+    return taps / numpy.sum(taps)
+
+#
+# Polyphase filterbank channelizer
+#
+# The input is split into numChannels channels, each decimated by
+# numChannels. Rather than mixing, filtering and decimating each channel
+# separately, every output frame comes from a single pass: the last
+# len(taps) input values are multiplied by the prototype filter, folded into
+# numChannels values by summing every numChannels-th product, and transformed
+# with one FFT.
+#
+
+class ChannelizerBlock(BaseBlock):
+    def __init__(self, dtype, numChannels, taps, outputMode):
+        dtype = Utility.toDType(dtype)
+
+        if numChannels < 1:
+            raise ValueError("numChannels must be at least 1.")
+        if outputMode not in ["VECTOR", "PORTS"]:
+            raise ValueError("Invalid output mode: {0}. Valid values: VECTOR, PORTS".format(outputMode))
+
+        self.__numChannels = numChannels
+        self.__outputMode = outputMode
+
+        complexDType = Utility.dtypeToComplexFloat(dtype)
+        if outputMode == "VECTOR":
+            outputDType = Utility.DType(complexDType.name(), numChannels)
+        else:
+            outputDType = complexDType
+
+        BaseBlock.__init__(
+            self,
+            "/numpy/channelizer",
+            numpy.fft.fft,
+            dtype,
+            outputDType,
+            dict(supportFloat=True, supportComplex=True, supportCInt=True),
+            dict(supportComplex=True, supportVector=True),
+            list(),
+            dict(),
+            useDType=False)
+
+        self.__numOutputPorts = 1 if (outputMode == "VECTOR") else numChannels
+
+        self.setupInput(0, self.inputDType)
+        for port in range(self.__numOutputPorts):
+            self.setupOutput(port, self.outputDType)
+
+        self.setTaps(taps)
+
+        self.registerProbe("numChannels")
+        self.registerProbe("taps")
+        self.registerProbe("outputMode")
+
+    def numChannels(self):
+        return self.__numChannels
+
+    def taps(self):
+        return self.__taps
+
+    # An empty list uses a default prototype filter.
+    def setTaps(self, taps):
+        taps = numpy.array(taps, dtype=numpy.float64).reshape(-1)
+        if 0 == len(taps):
+            taps = getDefaultPrototypeTaps(self.__numChannels)
+
+        self.__taps = taps.tolist()
+
+        # Real taps in the input's precision, so complex64 input stays
+        # complex64.
+        tapsDType = Utility.dtypeToNumPy(Utility.dtypeToScalar(self.outputDType))
+        self.__polyphaseTaps = getPolyphaseTaps(taps, self.__numChannels, tapsDType)
+
+        # The past values each output frame needs stay in the input buffer.
+        self.input(0).setReserve(self.__polyphaseTaps.size)
+
+    def outputMode(self):
+        return self.__outputMode
+
+    def work(self):
+        in0 = self.input(0).buffer()
+
+        M = self.__numChannels
+        (P, _) = self.__polyphaseTaps.shape
+        if len(in0) < (P * M):
+            return
+
+        outs = [self.output(port).buffer() for port in range(self.__numOutputPorts)]
+        numFrames = min([((len(in0) - (P * M)) // M) + 1] + [len(out) for out in outs])
+        if numFrames <= 0:
+            return
+
+        # View the input as (frame, phase row, channel) without copying. Each
+        # frame starts M values after the last.
+        samples = self.toNumPyInput(in0[:((numFrames - 1) * M) + (P * M)])
+        stride = samples.strides[0]
+        frames = numpy.lib.stride_tricks.as_strided(
+                     samples,
+                     shape=(numFrames, P, M),
+                     strides=(M * stride, M * stride, stride),
+                     writeable=False)
+
+        folded = numpy.einsum("fpm,pm->fm", frames, self.__polyphaseTaps)
+        spectra = self.func(folded, axis=1)
+
+        if self.__outputMode == "VECTOR":
+            outs[0][:numFrames] = spectra
+        else:
+            for chan in range(M):
+                outs[chan][:numFrames] = spectra[:, chan]
+
+        self.input(0).consume(numFrames * M)
+        for port in range(self.__numOutputPorts):
+            self.output(port).produce(numFrames)
+
+#
+# Streaming FIR filter
+#
+# Filters the input with the given taps, optionally interpolating by L
+# (zero-stuffing before the filter) and decimating by D (keeping every D-th
+# value after it). The taps are split into L phases, so zero-stuffed values
+# are never multiplied, and only the outputs that are kept are computed.
+#
+
+class FIRFilterBlock(BaseBlock):
+    def __init__(self, dtype, taps, interpolation, decimation):
+        if interpolation < 1:
+            raise ValueError("interpolation must be at least 1.")
+        if decimation < 1:
+            raise ValueError("decimation must be at least 1.")
+
+        dtypeArgs = dict(supportFloat=True, supportComplex=True)
+        BaseBlock.__init__(self, "/numpy/fir_filter", None, dtype, dtype, dtypeArgs, dtypeArgs, list(), dict(), useDType=False)
+
+        self.__interpolation = interpolation
+        self.__decimation = decimation
+
+        self.setupInput(0, self.inputDType)
+        self.setupOutput(0, self.outputDType)
+
+        self.setTaps(taps)
+
+        self.registerProbe("taps")
+        self.registerProbe("interpolation")
+        self.registerProbe("decimation")
+
+    def taps(self):
+        return self.__taps
+
+    # An empty list uses a default low-pass filter for the rate change.
+    # Complex taps need a complex data type.
+    def setTaps(self, taps):
+        L = self.__interpolation
+
+        taps = numpy.array(taps).reshape(-1)
+        if 0 == len(taps):
+            taps = getDefaultPrototypeTaps(max(L, self.__decimation)) * L
+
+        if numpy.iscomplexobj(taps):
+            if not self.inputDType.isComplex():
+                raise ValueError("Complex taps require a complex data type.")
+
+            tapsDType = Utility.dtypeToNumPy(self.inputDType)
+        else:
+            tapsDType = Utility.dtypeToNumPy(Utility.dtypeToScalar(Utility.dtypeToComplex(self.inputDType)))
+
+        self.__taps = taps.tolist()
+
+        # Phase p's taps are taps[p::L], reversed so each output is the dot
+        # product of the phase's taps and a contiguous run of inputs.
+        polyphaseTaps = getPolyphaseTaps(taps, L, tapsDType)
+        self.__phaseTaps = numpy.ascontiguousarray(polyphaseTaps.T[:, ::-1])
+
+        # The last (numPhaseTaps - 1) inputs, initially zero, so the first
+        # outputs match a filter starting from rest. Outputs that need them
+        # are computed from the scratch buffer, which holds the history
+        # followed by as many new inputs, so the input buffer is never copied.
+        numHistory = self.__phaseTaps.shape[1] - 1
+        self.__history = numpy.zeros(numHistory, dtype=self.numpyInputDType)
+        self.__scratch = numpy.zeros(2 * numHistory, dtype=self.numpyInputDType)
+
+        # The time of the next output, in interpolated samples from the first
+        # unconsumed input
+        self.__nextTime = 0
+
+    def interpolation(self):
+        return self.__interpolation
+
+    def decimation(self):
+        return self.__decimation
+
+    def work(self):
+        elems = self.workInfo().minAllElements
+        if 0 == elems:
+            return
+
+        in0 = self.input(0).buffer()
+        out0 = self.output(0).buffer()
+
+        L = self.__interpolation
+        D = self.__decimation
+        (_, J) = self.__phaseTaps.shape
+        numInputs = len(in0)
+
+        # Outputs are at times nextTime + (k * D), each of which needs the
+        # input at time // L.
+        numOutputs = min(len(out0), max(0, -(-((numInputs * L) - self.__nextTime) // D)))
+        if 0 == numOutputs:
+            return
+
+        # Outputs whose first input is in the history come from the scratch
+        # buffer, and the rest straight from the input buffer, whose times
+        # are (J - 1) inputs earlier.
+        numScratchInputs = min(numInputs, J - 1)
+        self.__scratch[:J - 1] = self.__history
+        self.__scratch[J - 1:(J - 1) + numScratchInputs] = in0[:numScratchInputs]
+
+        historyTime = (J - 1) * L
+        numHistoryOutputs = min(numOutputs, max(0, -(-(historyTime - self.__nextTime) // D)))
+        self.__filter(
+            self.__scratch[:(J - 1) + numScratchInputs],
+            out0[:numHistoryOutputs],
+            self.__nextTime)
+        self.__filter(
+            in0[:numInputs],
+            out0[numHistoryOutputs:numOutputs],
+            self.__nextTime + (numHistoryOutputs * D) - historyTime)
+
+        endTime = self.__nextTime + (numOutputs * D)
+        numConsumed = min(numInputs, endTime // L)
+        self.__nextTime = endTime - (numConsumed * L)
+
+        if numConsumed >= (J - 1):
+            self.__history[:] = in0[numConsumed - (J - 1):numConsumed]
+        else:
+            self.__history[:] = self.__scratch[numConsumed:numConsumed + (J - 1)]
+
+        self.input(0).consume(numConsumed)
+        self.output(0).produce(numOutputs)
+
+    # Computes the outputs starting at the given time, in interpolated
+    # samples from values[J - 1].
+    def __filter(self, values, out, time):
+        if 0 == len(out):
+            return
+
+        (_, J) = self.__phaseTaps.shape
+        if (1 == self.__interpolation) and (1 == self.__decimation):
+            out[:] = numpy.convolve(values[time:time + (J - 1) + len(out)], self.__phaseTaps[0][::-1], mode="valid")
+        else:
+            self.__filterPolyphase(values, out, time)
+
+    # Outputs k, k + period, k + 2*period, ... share a phase, and their inputs
+    # are evenly spaced, so each such set is one strided view and one einsum.
+    def __filterPolyphase(self, values, out, startTime):
+        L = self.__interpolation
+        D = self.__decimation
+        (_, J) = self.__phaseTaps.shape
+
+        period = L // math.gcd(L, D)
+        inputStep = (D * period) // L
+        itemStride = values.strides[0]
+
+        for first in range(min(period, len(out))):
+            time = startTime + (first * D)
+            numPhaseOutputs = len(range(first, len(out), period))
+
+            # Row r is the J inputs ending at this set's r-th output's input.
+            rows = numpy.lib.stride_tricks.as_strided(
+                       values[time // L:],
+                       shape=(numPhaseOutputs, J),
+                       strides=(inputStep * itemStride, itemStride),
+                       writeable=False)
+
+            out[first::period] = numpy.einsum("rj,j->r", rows, self.__phaseTaps[time % L])
+
+#
+# Factories exposed to C++ layer
+#
+
+"""
+/*
+ * |PothosDoc Polyphase Channelizer
+ *
+ * Split the input into <b>numChannels</b> evenly spaced channels with a
+ * polyphase filterbank, each decimated by <b>numChannels</b>.
+ *
+ * Channel <b>k</b> is centered at <b>k/numChannels</b> times the input
+ * sample rate, in the same order as the bins of <b>/numpy/fft/fft</b>, and is
+ * filtered by the prototype low-pass filter given by <b>taps</b>. Every
+ * <b>numChannels</b> input values produce one value per channel, computed
+ * with a single multiply-and-fold over the last <b>len(taps)</b> input values
+ * and one FFT. All frames available are computed at once, and the input
+ * history each frame needs is kept across calls.
+ *
+ * A complex tone at a channel's center with amplitude <b>A</b> reads
+ * <b>A * sum(taps)</b> in that channel.
+ *
+ * |category /NumPy/Filter
+ * |keywords channelizer polyphase filterbank pfb fft decimate channel
+ * |factory /numpy/channelizer(dtype,numChannels,taps,outputMode)
+ * |setter setTaps(taps)
+ * |setter setBackendNumThreads(backendNumThreads)
+ *
+ * |param dtype[Input Data Type] The block data type.
+ * |widget DTypeChooser(float=1,cfloat=1,cint=1)
+ * |default "complex_float64"
+ * |preview disable
+ *
+ * |param numChannels[Num Channels] The number of channels, and the decimation factor.
+ * |widget SpinBox(minimum=1)
+ * |default 16
+ * |preview enable
+ *
+ * |param taps[Taps] The prototype low-pass filter, zero-padded to a multiple of <b>numChannels</b>.
+ * If empty, a Hamming-windowed sinc filter with 8 taps per channel and unity gain at DC is used.
+ * |widget LineEdit()
+ * |default []
+ * |preview enable
+ *
+ * |param outputMode[Output Mode] How channels are output.
+ * <ul>
+ * <li><b>VECTOR</b>: one port, each of whose elements holds one value per channel.</li>
+ * <li><b>PORTS</b>: one port per channel.</li>
+ * </ul>
+ * |widget ComboBox(editable=False)
+ * |default "VECTOR"
+ * |option [Vector] "VECTOR"
+ * |option [Ports] "PORTS"
+ * |preview disable
+ *
+ * |param backendNumThreads[Backend Num Threads] The maximum number of threads NumPy's FFT backend may
+ * use while this block exists, or 0 for no limit of its own. This only has an effect when NumPy's FFTs
+ * are backed by a threaded library, such as MKL, and requires the threadpoolctl module. The thread
+ * count is process-wide, so every block uses the smallest of the global limit and all blocks' limits.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview disable
+ */
+"""
+def Channelizer(dtype, numChannels, taps, outputMode):
+    return ChannelizerBlock(dtype, numChannels, taps, outputMode)
+
+"""
+/*
+ * |PothosDoc FIR Filter
+ *
+ * Filter the input with a finite impulse response filter, optionally
+ * changing its sample rate by <b>interpolation/decimation</b>.
+ *
+ * The input is conceptually zero-stuffed by <b>interpolation</b>, filtered
+ * with <b>taps</b>, and decimated by <b>decimation</b>. The taps are split
+ * into polyphase components, so the zeros are never multiplied and only the
+ * outputs that are kept are computed. The filter's history is kept across
+ * calls, starting from zeros.
+ *
+ * As with any interpolator, the taps need a gain of <b>interpolation</b> for
+ * the passband to have unity gain.
+ *
+ * |category /NumPy/Filter
+ * |keywords fir filter decimate interpolate resample polyphase taps
+ * |factory /numpy/fir_filter(dtype,taps,interpolation,decimation)
+ * |setter setTaps(taps)
+ * |setter setBackendNumThreads(backendNumThreads)
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(float=1,cfloat=1)
+ * |default "complex_float64"
+ * |preview disable
+ *
+ * |param taps[Taps] The filter's taps, at the interpolated sample rate.
+ * Taps may be complex if the data type is complex.
+ * If empty, a Hamming-windowed sinc low-pass filter with a cutoff for the rate change is used.
+ * |widget LineEdit()
+ * |default []
+ * |preview enable
+ *
+ * |param interpolation[Interpolation]
+ * |widget SpinBox(minimum=1)
+ * |default 1
+ * |preview enable
+ *
+ * |param decimation[Decimation]
+ * |widget SpinBox(minimum=1)
+ * |default 1
+ * |preview enable
+ *
+ * |param backendNumThreads[Backend Num Threads] The maximum number of threads NumPy's BLAS library may
+ * use while this block exists, or 0 for no limit of its own. Without rate changes, taps are applied
+ * with <b>numpy.convolve</b>, which calls into BLAS. Requires the threadpoolctl module. The thread
+ * count is process-wide, so every block uses the smallest of the global limit and all blocks' limits.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview disable
+ */
+"""
+def FIRFilter(dtype, taps, interpolation, decimation):
+    return FIRFilterBlock(dtype, taps, interpolation, decimation)
@@ -38,19 +38,33 @@ class ForwardAndPostLabelBlock(BaseBlock):
         buf = self.input(0).takeBuffer()
         numpyRet = None
 
-        if self.useDType:
-            numpyRet = self.func(buf, *self.funcArgs, dtype=self.numpyInputDType)
+        # The buffer itself is forwarded unchanged, so only the values used
+        # for the calculation are widened from complex integers.
+        values = self.toNumPyInput(buf)
+
+        funcKWargs = dict(dtype=self.numpyInputDType) if self.useDType else dict()
+
+        if self.inputDimension > 1:
+            # Each element is a frame, so calculate every frame's value in a
+            # single call.
+            numpyRet = self.func(values, *self.funcArgs, axis=1, **funcKWargs)
+            self.processAndPostFrames(numpyRet, buf)
         else:
-            numpyRet = self.func(buf, *self.funcArgs)
+            (numpyRet, index) = self.calculateBuffer(values, funcKWargs)
+            self.processAndPostBuffer(numpyRet, index, buf)
 
-        self.processAndPostBuffer(numpyRet, buf)
+    # Returns the value to post and the index to post it at.
+    def calculateBuffer(self, values, funcKWargs):
+        numpyRet = self.func(values, *self.funcArgs, **funcKWargs)
 
-    def processAndPostBuffer(self, numpyRet, buf):
         if self.findIndexFunc:
-            index = self.findIndexFunc(buf)
+            index = self.findIndexFunc(values)
         else:
             index = 0
 
+        return (numpyRet, index)
+
+    def processAndPostBuffer(self, numpyRet, index, buf):
         self.input(0).consume(len(buf))
 
         self.output(0).postLabel(Pothos.Label(self.labelName, numpyRet, index))
@@ -58,6 +72,16 @@ class ForwardAndPostLabelBlock(BaseBlock):
 
         self.__lastValue = numpyRet
 
+    # Each frame gets its own label, at the frame's index.
+    def processAndPostFrames(self, numpyRets, buf):
+        self.input(0).consume(len(buf))
+
+        for (index, numpyRet) in enumerate(numpyRets):
+            self.output(0).postLabel(Pothos.Label(self.labelName, numpyRet, index))
+        self.output(0).postBuffer(buf)
+
+        self.__lastValue = numpyRets[-1]
+
     def lastValue(self):
         return self.__lastValue
 
@@ -65,6 +89,38 @@ class ForwardAndPostLabelBlock(BaseBlock):
 # Subclasses
 #
 
+# Returns the median of a one-dimensional array and the index of the value it
+# was taken from, using a selection instead of a sort. For an even number of
+# values, the median is the mean of the two middle values, and the index is
+# the lower one's. Without ignoreNaN, any NaN makes the median NaN, and the
+# index is the first NaN's.
+def medianAndIndex(values, ignoreNaN):
+    indices = None
+    if values.dtype.kind in "fc":
+        nanIndices = numpy.flatnonzero(numpy.isnan(values))
+        if len(nanIndices) > 0:
+            if not ignoreNaN:
+                return (values[nanIndices[0]], nanIndices[0])
+
+            indices = numpy.flatnonzero(~numpy.isnan(values))
+            values = values[indices]
+            if 0 == len(values):
+                return (numpy.nan, 0)
+
+    middle = len(values) // 2
+    if len(values) % 2:
+        order = numpy.argpartition(values, middle)
+        middleOrder = order[middle:middle+1]
+    else:
+        order = numpy.argpartition(values, [middle-1, middle])
+        middleOrder = order[middle-1:middle+1]
+
+    # Integer medians are floating-point, as with numpy.median.
+    median = numpy.mean(values[middleOrder])
+    index = middleOrder[0] if indices is None else indices[middleOrder[0]]
+
+    return (median, index)
+
 # Needed because the array index associated with the label depends on the return
 # value as well as the buffer
 class Median(ForwardAndPostLabelBlock):
@@ -74,11 +130,8 @@ class Median(ForwardAndPostLabelBlock):
         kwargs = dict(useDType=False)
         ForwardAndPostLabelBlock.__init__(self, "/numpy/median", medianFunc, dtype, dtype, dtypeArgs, dtypeArgs, None, "MEDIAN", list(), dict(), **kwargs)
 
-    def processAndPostBuffer(self, numpyRet, buf):
-        # numpy.where returns a tuple of ndarrays
-        arrIndex = numpy.where(buf == numpyRet)[0][0]
+        self.__ignoreNaN = ignoreNaN
 
-        self.input(0).consume(len(buf))
-
-        self.output(0).postLabel(Pothos.Label(self.labelName, numpyRet, arrIndex))
-        self.output(0).postBuffer(buf)
+    # The median and its index come from the same selection.
+    def calculateBuffer(self, values, funcKWargs):
+        return medianAndIndex(values, self.__ignoreNaN)
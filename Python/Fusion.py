@@ -0,0 +1,216 @@
+# Copyright (c) 2019-2020 Nicholas Corgan
+# SPDX-License-Identifier: BSD-3-Clause
+
+from .BaseBlock import *
+from .OneToOneBlock import *
+
+from . import ThreadPool
+from . import Utility
+
+import Pothos
+
+import numpy
+
+#
+# Element-wise chain fusion
+#
+# Each block in a chain like negative -> exp -> rint makes its own pass over
+# every buffer. A chain of element-wise blocks can instead be run as a single
+# block that applies each step to a cache-sized tile before moving on to the
+# next tile. With the default 8 KiB buffers, a buffer is a single tile, so
+# this saves the chain's buffer hand-offs rather than cache misses, and tiles
+# are only split across threads downstream of blocks that post larger
+# buffers.
+#
+# Fusion is opt-in. Pothos gives a toolkit no way to rewrite a topology when
+# it's committed, so topologies loaded from .pothos files or built in the GUI
+# aren't fused. Chains are only fused in a FusingTopology, or by connecting a
+# FusedChainBlock by hand. Only single-input blocks are fused, so two-input
+# blocks like copysign always run on their own.
+#
+
+def isFusable(block):
+    return isinstance(block, OneToOneBlock) and block.isElementwise and \
+           (not block.callPostBuffer) and \
+           (block.inputComplexIntDType is None) and (block.outputComplexIntDType is None)
+
+# Runs a chain of element-wise blocks as one block. The original blocks
+# aren't part of the topology, but they still own their parameters, so their
+# probes and setters keep working.
+class FusedChainBlock(BaseBlock):
+    def __init__(self, blocks):
+        if len(blocks) < 2:
+            raise ValueError("A fused chain needs at least two blocks.")
+        for block in blocks:
+            if not isFusable(block):
+                raise ValueError("{0} is not an element-wise block.".format(block.getName()))
+
+        self.__blocks = list(blocks)
+        blockPath = " -> ".join([block.getName() for block in blocks])
+
+        # The blocks have already validated their types.
+        dtypeArgs = dict(supportAll=True, supportVector=True)
+        BaseBlock.__init__(self, blockPath, None, blocks[0].inputDType, blocks[-1].outputDType, dtypeArgs, dtypeArgs, list(), dict(), useDType=False)
+
+        self.setupInput(0, self.inputDType)
+        self.setupOutput(0, self.outputDType)
+
+    def blocks(self):
+        return self.__blocks
+
+    def work(self):
+        elems = self.workInfo().minAllInElements
+        if 0 == elems:
+            return
+
+        (out0, isPosted) = self.getTiledOutputBuffer(elems)
+        elems = len(out0)
+        if 0 == elems:
+            return
+
+        in0 = self.input(0).buffer()[:elems]
+
+        def processTile(start, stop, worker):
+            for tileStart in range(start, stop, Utility.ElementwiseTileElements):
+                tileStop = min(tileStart + Utility.ElementwiseTileElements, stop)
+
+                values = in0[tileStart:tileStop]
+                for block in self.__blocks[:-1]:
+                    # Match the conversion each block's output buffer would do.
+                    values = block.evaluate(values).astype(block.numpyOutputDType, copy=False)
+
+                out0[tileStart:tileStop] = self.__blocks[-1].evaluate(values)
+
+        ThreadPool.runTiles(processTile, elems, self.numThreads())
+
+        self.input(0).consume(elems)
+        self.finishTiledOutput(out0, isPosted)
+
+# Returns lists of blocks in which each block's only output connection is to
+# the next block's only input. Flows are (source, source port, destination,
+# destination port) tuples.
+def findFusableChains(flows):
+    def key(block):
+        return id(block)
+
+    outFlows = dict()
+    inFlows = dict()
+    for flow in flows:
+        outFlows.setdefault(key(flow[0]), []).append(flow)
+        inFlows.setdefault(key(flow[2]), []).append(flow)
+
+    # The block after the given one, if the two can be fused
+    def nextInChain(block):
+        blockOutFlows = outFlows.get(key(block), [])
+        if 1 != len(blockOutFlows):
+            return None
+
+        nextBlock = blockOutFlows[0][2]
+        if (not isFusable(nextBlock)) or (1 != len(inFlows.get(key(nextBlock), []))):
+            return None
+
+        return nextBlock
+
+    chains = []
+    visited = set()
+    for flow in flows:
+        for block in [flow[0], flow[2]]:
+            if (key(block) in visited) or not isFusable(block):
+                continue
+
+            # Only start a chain at a block that doesn't continue one.
+            blockInFlows = inFlows.get(key(block), [])
+            if (1 == len(blockInFlows)) and isFusable(blockInFlows[0][0]) and (nextInChain(blockInFlows[0][0]) is block):
+                continue
+
+            chain = [block]
+            visited.add(key(block))
+            nextBlock = nextInChain(block)
+            while (nextBlock is not None) and (key(nextBlock) not in visited):
+                chain.append(nextBlock)
+                visited.add(key(nextBlock))
+                nextBlock = nextInChain(nextBlock)
+
+            if len(chain) > 1:
+                chains.append(chain)
+
+    return chains
+
+# Returns new flows in which each fusable chain is replaced with a
+# FusedChainBlock, along with the fused blocks.
+def fuseFlows(flows):
+    chains = findFusableChains(flows)
+
+    replacements = dict()
+    fusedBlocks = []
+    for chain in chains:
+        fusedBlock = FusedChainBlock(chain)
+        fusedBlocks.append(fusedBlock)
+        for block in chain:
+            replacements[id(block)] = fusedBlock
+
+    newFlows = []
+    for (src, srcPort, dst, dstPort) in flows:
+        fusedSrc = replacements.get(id(src))
+        fusedDst = replacements.get(id(dst))
+
+        if (fusedSrc is not None) and (fusedSrc is fusedDst):
+            # Internal to the chain
+            continue
+
+        # Only the ends of a chain connect to the rest of the topology.
+        newFlows.append((
+            src if (fusedSrc is None) else fusedSrc,
+            srcPort if (fusedSrc is None) else "0",
+            dst if (fusedDst is None) else fusedDst,
+            dstPort if (fusedDst is None) else "0"))
+
+    return (newFlows, fusedBlocks)
+
+# A drop-in replacement for Pothos.Topology that fuses chains of NumPy
+# element-wise blocks when committed. Connections are made on the underlying
+# topology at commit time. Plain Pothos.Topology instances are never fused.
+class FusingTopology(object):
+    def __init__(self, fuse=True):
+        self.__topology = Pothos.Topology()
+        self.__fuse = fuse
+        self.__flows = []
+        self.__committedFlows = []
+        self.__fusedBlocks = []
+
+    def fuse(self):
+        return self.__fuse
+
+    def setFuse(self, fuse):
+        self.__fuse = fuse
+
+    def connect(self, src, srcPort, dst, dstPort):
+        self.__flows.append((src, str(srcPort), dst, str(dstPort)))
+
+    def disconnect(self, src, srcPort, dst, dstPort):
+        self.__flows.remove((src, str(srcPort), dst, str(dstPort)))
+
+    def disconnectAll(self):
+        self.__flows = []
+
+    def fusedBlocks(self):
+        return self.__fusedBlocks
+
+    def commit(self):
+        if self.__fuse:
+            (newFlows, fusedBlocks) = fuseFlows(self.__flows)
+        else:
+            (newFlows, fusedBlocks) = (list(self.__flows), [])
+
+        for flow in self.__committedFlows:
+            self.__topology.disconnect(*flow)
+        for flow in newFlows:
+            self.__topology.connect(*flow)
+
+        self.__committedFlows = newFlows
+        self.__fusedBlocks = fusedBlocks
+        self.__topology.commit()
+
+    # Everything else is handled by the underlying topology.
+    def __getattr__(self, name):
+        return getattr(self.__topology, name)
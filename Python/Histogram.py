@@ -0,0 +1,351 @@
+# Copyright (c) 2019-2020 Nicholas Corgan
+# SPDX-License-Identifier: BSD-3-Clause
+
+from .BaseBlock import *
+from . import Utility
+
+import Pothos
+
+import numpy
+
+#
+# Streaming histograms
+#
+# Running counts are kept in a small array, and every interval input values,
+# a snapshot of them is output, either as a vector element or as a label on
+# the forwarded input. After each snapshot, the counts are multiplied by the
+# decay factor, so 1 keeps counting from the start of the stream and 0 gives
+# each interval's own histogram.
+#
+
+class HistogramBlockBase(BaseBlock):
+    def __init__(self, blockPath, dtype, dtypeArgs, numBins, interval, decay, outputMode):
+        dtype = Utility.toDType(dtype)
+
+        if numBins < 1:
+            raise ValueError("numBins must be at least 1.")
+        if outputMode not in ["VECTOR", "LABEL"]:
+            raise ValueError("Invalid output mode: {0}. Valid values: VECTOR, LABEL".format(outputMode))
+
+        self.__numBins = numBins
+        self.__outputMode = outputMode
+
+        if outputMode == "VECTOR":
+            outputDType = Utility.DType("float64", numBins)
+            outputDTypeArgs = dict(supportFloat=True, supportVector=True)
+        else:
+            outputDType = dtype
+            outputDTypeArgs = dtypeArgs
+
+        BaseBlock.__init__(self, blockPath, None, dtype, outputDType, dtypeArgs, outputDTypeArgs, list(), dict(), useDType=False)
+
+        self.setupInput(0, self.inputDType)
+        if outputMode == "VECTOR":
+            self.setupOutput(0, self.outputDType)
+        else:
+            # Unique domain because of buffer forwarding
+            self.setupOutput(0, self.outputDType, self.uid())
+
+        self.setInterval(interval)
+        self.setDecay(decay)
+
+        self.registerProbe("numBins")
+        self.registerProbe("interval")
+        self.registerProbe("decay")
+        self.registerProbe("outputMode")
+        self.registerProbe("counts")
+        self.registerSlot("reset")
+
+        self.reset()
+
+    def numBins(self):
+        return self.__numBins
+
+    def interval(self):
+        return self.__interval
+
+    def setInterval(self, interval):
+        if interval < 1:
+            raise ValueError("interval must be at least 1.")
+
+        self.__interval = interval
+
+    def decay(self):
+        return self.__decay
+
+    def setDecay(self, decay):
+        if (decay < 0.0) or (decay > 1.0):
+            raise ValueError("decay must be in the range [0, 1].")
+
+        self.__decay = decay
+
+    def outputMode(self):
+        return self.__outputMode
+
+    def counts(self):
+        return self.__counts.tolist()
+
+    def reset(self):
+        self.__counts = numpy.zeros(self.__numBins, dtype=numpy.float64)
+        self.__numSinceSnapshot = 0
+
+    # Returns the bin of each value, or -1 for values in no bin.
+    def binIndices(self, values):
+        raise NotImplementedError()
+
+    def work(self):
+        if self.__outputMode == "VECTOR":
+            self.workVector()
+        else:
+            self.workLabel()
+
+    # Counts the given values, and returns the indices of the values after
+    # which snapshots were taken, along with the snapshots.
+    def __countValues(self, values):
+        indices = self.binIndices(values)
+
+        snapshotIndices = []
+        snapshots = []
+        start = 0
+        while start < len(values):
+            stop = min(len(values), start + (self.__interval - self.__numSinceSnapshot))
+
+            binned = indices[start:stop]
+            self.__counts += numpy.bincount(binned[binned >= 0], minlength=self.__numBins)
+
+            self.__numSinceSnapshot += (stop - start)
+            start = stop
+
+            if self.__numSinceSnapshot == self.__interval:
+                snapshotIndices.append(stop - 1)
+                snapshots.append(self.__counts.copy())
+
+                self.__counts *= self.__decay
+                self.__numSinceSnapshot = 0
+
+        return (snapshotIndices, snapshots)
+
+    def workVector(self):
+        in0 = self.input(0).buffer()
+        out0 = self.output(0).buffer()
+        if (0 == len(in0)) or (0 == len(out0)):
+            return
+
+        # Only count as many values as there's room for the snapshots of.
+        maxValues = (len(out0) * self.__interval) - self.__numSinceSnapshot
+        numValues = min(len(in0), maxValues)
+
+        (_, snapshots) = self.__countValues(self.toNumPyInput(in0[:numValues]))
+
+        self.input(0).consume(numValues)
+        if snapshots:
+            out0[:len(snapshots)] = snapshots
+            self.output(0).produce(len(snapshots))
+
+    def workLabel(self):
+        if 0 == self.input(0).elements():
+            return
+
+        buf = self.input(0).takeBuffer()
+        (snapshotIndices, snapshots) = self.__countValues(self.toNumPyInput(buf))
+
+        self.input(0).consume(len(buf))
+        for (index, snapshot) in zip(snapshotIndices, snapshots):
+            self.output(0).postLabel(Pothos.Label("HISTOGRAM", snapshot.tolist(), index))
+        self.output(0).postBuffer(buf)
+
+class HistogramBlock(HistogramBlockBase):
+    def __init__(self, dtype, numBins, minimum, maximum, interval, decay, outputMode):
+        dtypeArgs = dict(supportInt=True, supportUInt=True, supportFloat=True)
+        HistogramBlockBase.__init__(self, "/numpy/histogram", dtype, dtypeArgs, numBins, interval, decay, outputMode)
+
+        self.setBinEdges(numpy.linspace(minimum, maximum, numBins + 1))
+
+        self.registerProbe("binEdges")
+
+    def binEdges(self):
+        return self.__binEdges.tolist()
+
+    # Bins are [edges[i], edges[i+1]), except for the last, which includes
+    # its upper edge, as with numpy.histogram.
+    def setBinEdges(self, binEdges):
+        binEdges = numpy.array(binEdges, dtype=numpy.float64).reshape(-1)
+        if len(binEdges) != (self.numBins() + 1):
+            raise ValueError("There must be numBins + 1 ({0}) bin edges.".format(self.numBins() + 1))
+        if not numpy.all(numpy.diff(binEdges) > 0):
+            raise ValueError("Bin edges must be strictly increasing.")
+
+        self.__binEdges = binEdges
+
+        # Uniform bins can be found with arithmetic instead of a search.
+        widths = numpy.diff(binEdges)
+        self.__isUniform = numpy.allclose(widths, widths[0], rtol=1e-9, atol=0.0)
+        self.reset()
+
+    def binIndices(self, values):
+        values = values.astype(numpy.float64, copy=False)
+        edges = self.__binEdges
+        numBins = len(edges) - 1
+
+        if self.__isUniform:
+            scaled = (values - edges[0]) * (numBins / (edges[-1] - edges[0]))
+            indices = numpy.clip(numpy.floor(numpy.nan_to_num(scaled, nan=-1.0)), -1, numBins).astype(numpy.int64)
+
+            # Values just below the maximum can round up past the last bin.
+            # Values that are actually past it are removed below.
+            indices[indices == numBins] = numBins - 1
+
+            # Rounding can put values next to an edge in the wrong bin, so
+            # check them against the edges themselves.
+            inRange = (indices >= 0) & (indices < numBins)
+            clipped = numpy.clip(indices, 0, numBins - 1)
+            indices[inRange & (values < edges[clipped])] -= 1
+            indices[inRange & (values >= edges[clipped + 1]) & (clipped < (numBins - 1))] += 1
+        else:
+            indices = numpy.searchsorted(edges, values, side="right") - 1
+
+        # The last bin includes its upper edge.
+        indices[values == edges[-1]] = numBins - 1
+        indices[(values < edges[0]) | (values > edges[-1]) | numpy.isnan(values)] = -1
+        indices[(indices < 0) | (indices >= numBins)] = -1
+
+        return indices
+
+class BinCountBlock(HistogramBlockBase):
+    def __init__(self, dtype, numBins, interval, decay, outputMode):
+        dtypeArgs = dict(supportInt=True, supportUInt=True)
+        HistogramBlockBase.__init__(self, "/numpy/bincount", dtype, dtypeArgs, numBins, interval, decay, outputMode)
+
+    # Each value is its own bin.
+    def binIndices(self, values):
+        indices = values.astype(numpy.int64)
+        indices[(indices < 0) | (indices >= self.numBins())] = -1
+
+        return indices
+
+#
+# Factories exposed to C++ layer
+#
+
+"""
+/*
+ * |PothosDoc Histogram
+ *
+ * Count how many input values fall in each of <b>numBins</b> bins, and output
+ * the counts every <b>interval</b> input values.
+ *
+ * By default, the bins evenly divide <b>[minimum, maximum]</b>. Other bin
+ * edges can be given with <b>setBinEdges</b>. As with <b>numpy.histogram</b>,
+ * each bin includes its lower edge, the last bin also includes its upper
+ * edge, and values outside of the bins aren't counted. Values are placed in
+ * even bins with arithmetic, and in uneven bins with a binary search.
+ *
+ * After each output, the counts are multiplied by <b>decay</b>. With a decay
+ * of 1, each output counts the whole stream so far. With 0, each output only
+ * counts its own interval.
+ *
+ * |category /NumPy/Stats
+ * |keywords histogram distribution bins count density
+ * |factory /numpy/histogram(dtype,numBins,minimum,maximum,interval,decay,outputMode)
+ * |setter setInterval(interval)
+ * |setter setDecay(decay)
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param numBins[Num Bins]
+ * |widget SpinBox(minimum=1)
+ * |default 64
+ * |preview enable
+ *
+ * |param minimum[Minimum] The lower edge of the first bin.
+ * |widget DoubleSpinBox()
+ * |default -1.0
+ * |preview enable
+ *
+ * |param maximum[Maximum] The upper edge of the last bin.
+ * |widget DoubleSpinBox()
+ * |default 1.0
+ * |preview enable
+ *
+ * |param interval[Interval] The number of input values between outputs.
+ * |widget SpinBox(minimum=1)
+ * |default 8192
+ * |preview enable
+ *
+ * |param decay[Decay] The factor the counts are multiplied by after each output.
+ * |widget DoubleSpinBox(minimum=0,maximum=1)
+ * |default 1.0
+ * |preview enable
+ *
+ * |param outputMode[Output Mode] How counts are output.
+ * <ul>
+ * <li><b>VECTOR</b>: as <b>float64</b> vector elements, one per output.</li>
+ * <li><b>LABEL</b>: as <b>"HISTOGRAM"</b> labels on the forwarded input, at the last value counted.</li>
+ * </ul>
+ * |widget ComboBox(editable=False)
+ * |default "VECTOR"
+ * |option [Vector] "VECTOR"
+ * |option [Label] "LABEL"
+ * |preview disable
+ */
+"""
+def Histogram(dtype, numBins, minimum, maximum, interval, decay, outputMode):
+    return HistogramBlock(dtype, numBins, minimum, maximum, interval, decay, outputMode)
+
+"""
+/*
+ * |PothosDoc Bin Count
+ *
+ * Count the occurrences of each integer in <b>[0, numBins)</b> in the input,
+ * and output the counts every <b>interval</b> input values. Other values
+ * aren't counted.
+ *
+ * After each output, the counts are multiplied by <b>decay</b>. With a decay
+ * of 1, each output counts the whole stream so far. With 0, each output only
+ * counts its own interval.
+ *
+ * Corresponding NumPy function: <b>numpy.bincount</b>
+ *
+ * |category /NumPy/Stats
+ * |keywords bincount histogram distribution count occurrences integer
+ * |factory /numpy/bincount(dtype,numBins,interval,decay,outputMode)
+ * |setter setInterval(interval)
+ * |setter setDecay(decay)
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1)
+ * |default "uint8"
+ * |preview disable
+ *
+ * |param numBins[Num Bins]
+ * |widget SpinBox(minimum=1)
+ * |default 256
+ * |preview enable
+ *
+ * |param interval[Interval] The number of input values between outputs.
+ * |widget SpinBox(minimum=1)
+ * |default 8192
+ * |preview enable
+ *
+ * |param decay[Decay] The factor the counts are multiplied by after each output.
+ * |widget DoubleSpinBox(minimum=0,maximum=1)
+ * |default 1.0
+ * |preview enable
+ *
+ * |param outputMode[Output Mode] How counts are output.
+ * <ul>
+ * <li><b>VECTOR</b>: as <b>float64</b> vector elements, one per output.</li>
+ * <li><b>LABEL</b>: as <b>"HISTOGRAM"</b> labels on the forwarded input, at the last value counted.</li>
+ * </ul>
+ * |widget ComboBox(editable=False)
+ * |default "VECTOR"
+ * |option [Vector] "VECTOR"
+ * |option [Label] "LABEL"
+ * |preview disable
+ */
+"""
+def BinCount(dtype, numBins, interval, decay, outputMode):
+    return BinCountBlock(dtype, numBins, interval, decay, outputMode)
@@ -55,7 +55,7 @@ class NToOneBlock(BaseBlock):
 
         # This creates a 2D ndarray containing the array subsets we're interested
         # in. This points to the input buffers themselves without copying memory.
-        allArrs = numpy.array([buf.buffer()[:N].view() for buf in self.inputs()], dtype=self.numpyInputDType)
+        allArrs = numpy.array([self.toNumPyInput(buf.buffer()[:N]).view() for buf in self.inputs()], dtype=self.numpyInputDType)
         out = None
 
         # TODO: what happens if a function doesn't take in *args or **kwargs?
@@ -67,16 +67,23 @@ class NToOneBlock(BaseBlock):
         if (out is not None) and (len(out) > 0):
             for port in self.inputs():
                 port.consume(N)
-            self.output(0).postBuffer(out)
+            self.output(0).postBuffer(self.fromNumPyOutput(out))
 
     def workWithGivenOutputBuffer(self):
         elems = self.workInfo().minAllElements
         if 0 == elems:
             return
 
+        if self.complexIntPairFunc is not None:
+            self.callComplexIntPairFunc([buf.buffer()[:elems] for buf in self.inputs()], self.output(0).buffer()[:elems])
+            for port in self.inputs():
+                port.consume(elems)
+            self.output(0).produce(elems)
+            return
+
         # This creates a 2D ndarray containing the array subsets we're interested
         # in. This points to the input buffers themselves without copying memory.
-        allArrs = numpy.array([buf.buffer()[:elems].view() for buf in self.inputs()], dtype=self.numpyInputDType)
+        allArrs = numpy.array([self.toNumPyInput(buf.buffer()[:elems]).view() for buf in self.inputs()], dtype=self.numpyInputDType)
         out0 = self.output(0).buffer()
         out = None
 
@@ -90,5 +97,5 @@ class NToOneBlock(BaseBlock):
             for port in self.inputs():
                 port.consume(elems)
 
-            out0[:elems] = out
+            self.writeOutput(out0[:elems], out)
             self.output(0).produce(elems)
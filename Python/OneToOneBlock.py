@@ -2,6 +2,8 @@
 # SPDX-License-Identifier: BSD-3-Clause
 
 from .BaseBlock import *
+from . import ThreadPool
+from . import Utility
 
 import Pothos
 
@@ -16,9 +18,42 @@ class OneToOneBlock(BaseBlock):
 
         BaseBlock.__init__(self, blockPath, func, inputDType, outputDType, inputDTypeArgs, outputDTypeArgs, funcArgs, funcKWargs, *args, **kwargs)
 
+        # Element-wise blocks are marked as such in their YAML entries. These
+        # are processed in tiles, and can be fused with each other.
+        self.isElementwise = kwargs.get("elementwise", False)
+
+        # Some functions can be evaluated in single precision, within known
+        # error bounds for inputs in this range.
+        self.fastMathRange = kwargs.get("fastMathRange", None)
+        self.supportsFastMath = (self.fastMathRange is not None)
+        self.__precision = "FULL"
+        self.__fastMathDType = None
+
         self.setupInput(0, self.inputDType)
         self.setupOutput(0, self.outputDType)
 
+    def precision(self):
+        return self.__precision
+
+    def setPrecision(self, precision):
+        if precision not in ["FULL", "FAST"]:
+            raise ValueError("Invalid precision: {0}. Valid values: FULL, FAST".format(precision))
+        if (precision == "FAST") and not self.supportsFastMath:
+            raise ValueError("{0} does not support FAST precision.".format(self.getName()))
+
+        self.__precision = precision
+        self.__fastMathDType = Utility.FastMathDTypes.get(self.numpyInputDType) if (precision == "FAST") else None
+
+    # Returns the result of this block's function on the given values, without
+    # converting to the output type.
+    def evaluate(self, values):
+        values = self.toNumPyInput(values)
+
+        if self.__fastMathDType is not None:
+            return Utility.evaluateFastMath(self.func, values, self.__fastMathDType, *self.fastMathRange)
+
+        return self.func(values, *self.funcArgs, **self.funcKWargs)
+
     def work(self):
         assert(self.numpyInputDType is not None)
         assert(self.numpyOutputDType is not None)
@@ -33,12 +68,11 @@ class OneToOneBlock(BaseBlock):
         if 0 == elems:
             return
 
-        in0 = self.input(0).buffer()
-        out = self.func(in0, *self.funcArgs, **self.funcKWargs).astype(self.numpyOutputDType, copy=False)
+        out = self.evaluate(self.input(0).buffer()).astype(self.numpyOutputDType, copy=False)
 
         if (out is not None) and (len(out) > 0):
             self.input(0).consume(elems)
-            self.output(0).postBuffer(out)
+            self.output(0).postBuffer(self.fromNumPyOutput(out))
 
     def workWithGivenOutputBuffer(self):
         elems = self.workInfo().minAllInElements
@@ -50,9 +84,29 @@ class OneToOneBlock(BaseBlock):
         N = min(len(in0), len(out0))
         out = None
 
-        out = self.func(in0[:N], *self.funcArgs, **self.funcKWargs).astype(self.numpyOutputDType, copy=False)
+        if self.complexIntPairFunc is not None:
+            self.callComplexIntPairFunc([in0[:N]], out0[:N])
+            self.input(0).consume(N)
+            self.output(0).produce(N)
+            return
+
+        if self.isElementwise:
+            (outBuf, isPosted) = self.getTiledOutputBuffer(len(in0))
+            N = len(outBuf)
+
+            # Assigning to the output buffer converts to the output type in
+            # the same pass as the copy.
+            def processTile(start, stop, worker):
+                self.writeOutput(outBuf[start:stop], self.evaluate(in0[start:stop]))
+
+            ThreadPool.runTiles(processTile, N, self.numThreads())
+            self.input(0).consume(N)
+            self.finishTiledOutput(outBuf, isPosted)
+            return
+
+        out = self.evaluate(in0[:N])
 
         if (out is not None) and (len(out) > 0):
-            out0[:N] = out
+            self.writeOutput(out0[:N], out)
             self.input(0).consume(N)
             self.output(0).produce(N)
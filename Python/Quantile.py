@@ -0,0 +1,340 @@
+# Copyright (c) 2019-2020 Nicholas Corgan
+# SPDX-License-Identifier: BSD-3-Clause
+
+from .BaseBlock import *
+from . import Utility
+
+import Pothos
+
+import numpy
+
+#
+# Streaming quantiles
+#
+# The input is forwarded, and every interval input values, the requested
+# quantiles are posted as a label. In TDIGEST mode, they're estimated for the
+# whole stream from a t-digest, whose size depends only on its compression.
+# In EXACT mode, they're calculated for each interval's own values with a
+# selection instead of a sort.
+#
+
+# The given quantiles of the values, interpolated linearly between the two
+# nearest values, as with numpy.quantile. Only the values on either side of
+# each quantile are put in place by numpy.partition, instead of sorting.
+def selectQuantiles(values, quantiles):
+    positions = numpy.asarray(quantiles) * (len(values) - 1)
+    lower = numpy.floor(positions).astype(numpy.int64)
+    upper = numpy.minimum(lower + 1, len(values) - 1)
+
+    partitioned = numpy.partition(values, numpy.unique(numpy.concatenate([lower, upper])))
+    fractions = positions - lower
+
+    return partitioned[lower] + ((partitioned[upper] - partitioned[lower]) * fractions)
+
+#
+# A merging t-digest, which summarizes a distribution as weighted centroids,
+# with small ones near the tails, where quantiles change quickly, and large
+# ones in the middle. There are at most about compression + 1 centroids.
+#
+class TDigest(object):
+    def __init__(self, compression):
+        if compression < 1:
+            raise ValueError("compression must be at least 1.")
+
+        self.__compression = compression
+        self.__means = numpy.zeros(0, dtype=numpy.float64)
+        self.__weights = numpy.zeros(0, dtype=numpy.float64)
+        self.__min = numpy.inf
+        self.__max = -numpy.inf
+
+    def compression(self):
+        return self.__compression
+
+    def centroids(self):
+        return (self.__means, self.__weights)
+
+    def totalWeight(self):
+        return numpy.sum(self.__weights)
+
+    # NaNs are ignored.
+    def update(self, values):
+        values = numpy.asarray(values, dtype=numpy.float64).reshape(-1)
+        values = values[~numpy.isnan(values)]
+
+        self.__add(values, numpy.ones(len(values)), numpy.min(values, initial=numpy.inf), numpy.max(values, initial=-numpy.inf))
+
+    # Digests of different parts of a stream can be combined into one.
+    def merge(self, other):
+        (means, weights) = other.centroids()
+        self.__add(means, weights, other.__min, other.__max)
+
+    def __add(self, means, weights, minimum, maximum):
+        if 0 == len(means):
+            return
+
+        self.__min = min(self.__min, minimum)
+        self.__max = max(self.__max, maximum)
+
+        means = numpy.concatenate([self.__means, means])
+        weights = numpy.concatenate([self.__weights, weights])
+
+        order = numpy.argsort(means, kind="stable")
+        means = means[order]
+        weights = weights[order]
+
+        # Each centroid is assigned by its middle quantile to a unit of the
+        # arcsine scale function, which is steep at the tails, and all
+        # centroids in a unit are combined.
+        cumulativeWeights = numpy.cumsum(weights)
+        quantiles = (cumulativeWeights - (weights / 2)) / cumulativeWeights[-1]
+        scaled = numpy.floor((self.__compression / numpy.pi) * numpy.arcsin((2 * quantiles) - 1))
+
+        clusters = numpy.concatenate([[0], numpy.cumsum(numpy.diff(scaled) != 0)])
+        self.__weights = numpy.bincount(clusters, weights)
+        self.__means = numpy.bincount(clusters, weights * means) / self.__weights
+
+    # Quantiles are interpolated between the centroids' middle quantiles,
+    # and between the outer centroids and the extremes. Returns NaNs if no
+    # values have been added.
+    def quantile(self, quantiles):
+        quantiles = numpy.asarray(quantiles, dtype=numpy.float64)
+        if 0 == len(self.__weights):
+            return numpy.full(quantiles.shape, numpy.nan)
+
+        cumulativeWeights = numpy.cumsum(self.__weights)
+        positions = (cumulativeWeights - (self.__weights / 2)) / cumulativeWeights[-1]
+
+        return numpy.interp(
+                   quantiles,
+                   numpy.concatenate([[0.0], positions, [1.0]]),
+                   numpy.concatenate([[self.__min], self.__means, [self.__max]]))
+
+class QuantileBlock(BaseBlock):
+    def __init__(self, blockPath, dtype, quantiles, scale, interval, mode, compression):
+        dtype = Utility.toDType(dtype)
+        dtypeArgs = dict(supportInt=True, supportUInt=True, supportFloat=True)
+
+        if mode not in ["TDIGEST", "EXACT"]:
+            raise ValueError("Invalid mode: {0}. Valid values: TDIGEST, EXACT".format(mode))
+        if interval < 1:
+            raise ValueError("interval must be at least 1.")
+
+        BaseBlock.__init__(self, blockPath, None, dtype, dtype, dtypeArgs, dtypeArgs, list(), dict(), useDType=False)
+
+        self.setupInput(0, self.inputDType)
+
+        # Unique domain because of buffer forwarding
+        self.setupOutput(0, self.outputDType, self.uid())
+
+        # Percentiles are quantiles scaled by 100.
+        self.__scale = scale
+        self.__interval = interval
+        self.__mode = mode
+        self.__compression = compression
+        self.setQuantiles(quantiles)
+
+        self.registerProbe("quantiles")
+        self.registerProbe("interval")
+        self.registerProbe("mode")
+        self.registerProbe("compression")
+        self.registerProbe("lastValue")
+        self.registerSlot("reset")
+
+        self.reset()
+
+    def interval(self):
+        return self.__interval
+
+    def mode(self):
+        return self.__mode
+
+    def compression(self):
+        return self.__compression
+
+    def lastValue(self):
+        return self.__lastValue
+
+    def quantiles(self):
+        return (self.__quantiles * self.__scale).tolist()
+
+    def setQuantiles(self, quantiles):
+        quantiles = numpy.array(quantiles, dtype=numpy.float64).reshape(-1) / self.__scale
+        if 0 == len(quantiles):
+            raise ValueError("At least one quantile must be given.")
+        if numpy.any((quantiles < 0.0) | (quantiles > 1.0)):
+            raise ValueError("Quantiles must be in the range [0, {0}].".format(self.__scale))
+
+        self.__quantiles = quantiles
+
+    def reset(self):
+        self.__digest = TDigest(self.__compression)
+        self.__intervalValues = []
+        self.__numSinceLabel = 0
+        self.__lastValue = None
+
+    # NaNs are ignored.
+    def __calculate(self):
+        if self.__mode == "TDIGEST":
+            quantiles = self.__digest.quantile(self.__quantiles)
+        else:
+            values = numpy.concatenate(self.__intervalValues).astype(numpy.float64, copy=False)
+            values = values[~numpy.isnan(values)]
+            self.__intervalValues = []
+
+            if 0 == len(values):
+                quantiles = numpy.full(self.__quantiles.shape, numpy.nan)
+            else:
+                quantiles = selectQuantiles(values, self.__quantiles)
+
+        return quantiles.tolist()
+
+    def work(self):
+        if 0 == self.input(0).elements():
+            return
+
+        buf = self.input(0).takeBuffer()
+        values = self.toNumPyInput(buf)
+
+        labels = []
+        start = 0
+        while start < len(values):
+            stop = min(len(values), start + (self.__interval - self.__numSinceLabel))
+
+            if self.__mode == "TDIGEST":
+                self.__digest.update(values[start:stop])
+            else:
+                self.__intervalValues.append(values[start:stop].copy())
+
+            self.__numSinceLabel += (stop - start)
+            start = stop
+
+            if self.__numSinceLabel == self.__interval:
+                self.__lastValue = self.__calculate()
+                labels.append(Pothos.Label(self.labelName(), self.__lastValue, stop - 1))
+                self.__numSinceLabel = 0
+
+        self.input(0).consume(len(buf))
+        for label in labels:
+            self.output(0).postLabel(label)
+        self.output(0).postBuffer(buf)
+
+    def labelName(self):
+        return "QUANTILES" if (self.__scale == 1.0) else "PERCENTILES"
+
+#
+# Factories exposed to C++ layer
+#
+
+"""
+/*
+ * |PothosDoc Quantile
+ *
+ * Estimate the given quantiles of the input stream, and post them every
+ * <b>interval</b> input values.
+ *
+ * The input buffer is forwarded without copying, and the quantiles are posted
+ * as a list under the label <b>"QUANTILES"</b>, at the last value counted.
+ * NaNs are ignored.
+ *
+ * <ul>
+ * <li><b>TDIGEST</b>: estimate the quantiles of the whole stream so far with
+ * a t-digest, a summary of the distribution whose size depends only on the
+ * <b>compression</b>. Higher compressions are more accurate, especially near
+ * the median.</li>
+ * <li><b>EXACT</b>: calculate the quantiles of each interval's own values,
+ * as with <b>numpy.quantile</b>, using a selection instead of a full sort.
+ * Each interval's values are kept until its quantiles are posted.</li>
+ * </ul>
+ *
+ * |category /NumPy/Stats
+ * |keywords quantile percentile median streaming tdigest sketch estimate
+ * |factory /numpy/quantile(dtype,quantiles,interval,mode,compression)
+ * |setter setQuantiles(quantiles)
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param quantiles[Quantiles] The quantiles to calculate, each in the range [0, 1].
+ * |widget LineEdit()
+ * |default [0.25, 0.5, 0.75]
+ * |preview enable
+ *
+ * |param interval[Interval] The number of input values between labels.
+ * |widget SpinBox(minimum=1)
+ * |default 8192
+ * |preview enable
+ *
+ * |param mode[Mode]
+ * |widget ComboBox(editable=False)
+ * |default "TDIGEST"
+ * |option [T-Digest] "TDIGEST"
+ * |option [Exact] "EXACT"
+ * |preview enable
+ *
+ * |param compression[Compression] The approximate maximum number of t-digest centroids.
+ * |widget SpinBox(minimum=1)
+ * |default 100
+ * |preview when(enum=mode, "TDIGEST")
+ */
+"""
+def Quantile(dtype, quantiles, interval, mode, compression):
+    return QuantileBlock("/numpy/quantile", dtype, quantiles, 1.0, interval, mode, compression)
+
+"""
+/*
+ * |PothosDoc Percentile
+ *
+ * Estimate the given percentiles of the input stream, and post them every
+ * <b>interval</b> input values.
+ *
+ * The input buffer is forwarded without copying, and the percentiles are
+ * posted as a list under the label <b>"PERCENTILES"</b>, at the last value
+ * counted. NaNs are ignored.
+ *
+ * <ul>
+ * <li><b>TDIGEST</b>: estimate the percentiles of the whole stream so far
+ * with a t-digest, a summary of the distribution whose size depends only on
+ * the <b>compression</b>. Higher compressions are more accurate, especially
+ * near the median.</li>
+ * <li><b>EXACT</b>: calculate the percentiles of each interval's own values,
+ * as with <b>numpy.percentile</b>, using a selection instead of a full sort.
+ * Each interval's values are kept until its percentiles are posted.</li>
+ * </ul>
+ *
+ * |category /NumPy/Stats
+ * |keywords quantile percentile median streaming tdigest sketch estimate
+ * |factory /numpy/percentile(dtype,percentiles,interval,mode,compression)
+ * |setter setQuantiles(percentiles)
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param percentiles[Percentiles] The percentiles to calculate, each in the range [0, 100].
+ * |widget LineEdit()
+ * |default [25, 50, 75]
+ * |preview enable
+ *
+ * |param interval[Interval] The number of input values between labels.
+ * |widget SpinBox(minimum=1)
+ * |default 8192
+ * |preview enable
+ *
+ * |param mode[Mode]
+ * |widget ComboBox(editable=False)
+ * |default "TDIGEST"
+ * |option [T-Digest] "TDIGEST"
+ * |option [Exact] "EXACT"
+ * |preview enable
+ *
+ * |param compression[Compression] The approximate maximum number of t-digest centroids.
+ * |widget SpinBox(minimum=1)
+ * |default 100
+ * |preview when(enum=mode, "TDIGEST")
+ */
+"""
+def Percentile(dtype, percentiles, interval, mode, compression):
+    return QuantileBlock("/numpy/percentile", dtype, percentiles, 100.0, interval, mode, compression)
@@ -47,6 +47,56 @@ def getNumPyConfigInfoJSONString():
 
     return json.dumps(topLevel)
 
+# NumPy compiles its element-wise, conversion and reduction loops for several
+# instruction sets and picks one at import, based on what the CPU supports.
+# The NPY_DISABLE_CPU_FEATURES and NPY_ENABLE_CPU_FEATURES environment
+# variables, read when NumPy is imported, can limit this to a lower tier.
+def getNumPyCPUFeatures():
+    try:
+        from numpy._core import _multiarray_umath
+    except ImportError:
+        try:
+            from numpy.core import _multiarray_umath
+        except ImportError:
+            return None
+
+    # These were added in NumPy 1.20.
+    if not hasattr(_multiarray_umath, "__cpu_dispatch__"):
+        return None
+
+    baseline = list(_multiarray_umath.__cpu_baseline__)
+    dispatch = list(_multiarray_umath.__cpu_dispatch__)
+    available = [feature for (feature, isAvailable) in _multiarray_umath.__cpu_features__.items() if isAvailable]
+
+    # Dispatch targets are listed from lowest to highest. The selected target
+    # is the highest one enabled, which is the most any loop can use. Each
+    # loop uses the highest one it was compiled for.
+    enabledDispatch = [feature for feature in dispatch if feature in available]
+    if enabledDispatch:
+        selected = enabledDispatch[-1]
+    elif baseline:
+        selected = baseline[-1]
+    else:
+        selected = "None"
+
+    cpuFeatures = dict()
+    cpuFeatures["Baseline"] = ",".join(baseline)
+    cpuFeatures["Dispatch Targets"] = ",".join(dispatch)
+    cpuFeatures["Enabled Dispatch Targets"] = ",".join(enabledDispatch)
+    cpuFeatures["Selected Target"] = selected
+    cpuFeatures["Available Features"] = ",".join(available)
+    for var in ["NPY_DISABLE_CPU_FEATURES", "NPY_ENABLE_CPU_FEATURES"]:
+        if var in os.environ:
+            cpuFeatures[var] = os.environ[var]
+
+    return cpuFeatures
+
+def getNumPyCPUInfoJSONString():
+    topLevel = dict()
+    topLevel["NumPy CPU Info"] = getNumPyCPUFeatures() or dict(Supported=False)
+
+    return json.dumps(topLevel)
+
 def getNumPyIntInfoFromPothosDType(pothosDType):
     pothosDType = Utility.dtypeToScalar(Utility.toDType(pothosDType))
     Utility.validateDType(pothosDType, dict(supportInt=True, supportUInt=True))
@@ -2,6 +2,7 @@
 # SPDX-License-Identifier: BSD-3-Clause
 
 from .BaseBlock import *
+from . import ThreadPool
 from . import Utility
 
 import Pothos
@@ -18,6 +19,21 @@ class SingleOutputSource(BaseBlock):
 
         self.useShape = kwargs.get("useShape", True)
 
+        # NumPy's random generators aren't thread-safe, so tiles are only
+        # generated in parallel if each worker can be given its own.
+        self.__generators = []
+        self.__generatorFuncName = None
+        if hasattr(numpy.random, "Generator") and isinstance(getattr(func, "__self__", None), numpy.random.Generator):
+            if self.sizeParam and not self.useShape:
+                self.__generatorFuncName = func.__name__
+
+    # A generator for each worker, each seeded separately
+    def __getGenerators(self, numWorkers):
+        while len(self.__generators) < numWorkers:
+            self.__generators.append(numpy.random.default_rng())
+
+        return self.__generators
+
     def work(self):
         assert(self.numpyOutputDType is not None)
 
@@ -39,9 +55,27 @@ class SingleOutputSource(BaseBlock):
         funcArgs = funcArgs + [elems] if self.sizeParam else funcArgs
 
         out0 = self.output(0).buffer()
-        out0[:elems] = self.func(*funcArgs, **self.funcKWargs).astype(self.numpyOutputDType, copy=False)
+
+        if (self.__generatorFuncName is not None) and (self.numThreads() > 1):
+            self.generateTiles(out0[:elems])
+        else:
+            out0[:elems] = self.func(*funcArgs, **self.funcKWargs)
+
         self.output(0).produce(elems)
 
+    # Fills the given buffer in tiles, each from the generator of the worker
+    # that processes it. A source has no input buffers to size its output by,
+    # so this only splits when the output buffer is larger than one tile,
+    # which the default buffer manager's (8 KiB) never are.
+    def generateTiles(self, outBuf):
+        generators = self.__getGenerators(self.numThreads())
+
+        def processTile(start, stop, worker):
+            func = getattr(generators[worker], self.__generatorFuncName)
+            outBuf[start:stop] = func(*(self.funcArgs + [stop-start]), **self.funcKWargs)
+
+        ThreadPool.runTiles(processTile, len(outBuf), self.numThreads())
+
 class FixedSingleOutputSource(SingleOutputSource):
     def __init__(self, blockPath, func, dtype, dtypeArgs, repeat, funcArgs, funcKWargs, *args, **kwargs):
         SingleOutputSource.__init__(self, blockPath, func, dtype, dtypeArgs, funcArgs, funcKWargs, *args, **kwargs)
@@ -3,10 +3,14 @@
 
 import Pothos
 from . import Random
+from . import ThreadPool
+from . import Utility
 
 import numpy
 
 import os
+import threading
+import time
 
 #
 # Checking inputs
@@ -34,6 +38,10 @@ def checkNpyContents(filepath, expectedValues):
     npyContents = numpy.load(filepath)
     checkArrayContents(expectedValues, npyContents)
 
+# The values are expected to have been stored as float16.
+def checkHalfPrecisionNpyContents(filepath, expectedValues):
+    checkNpyContents(filepath, expectedValues.astype("float16"))
+
 def checkNpzContents(filepath, expectedValues):
     if not os.path.exists(filepath):
         raise RuntimeError("Invalid filepath: {0}".format(filepath))
@@ -52,6 +60,16 @@ def checkNpzContents(filepath, expectedValues):
     for key in expectedKeys:
         checkArrayContents(expectedValues[key], npzContents[key])
 
+# Every column is expected to hold the given values.
+def checkTxtContents(filepath, delimiter, expectedValues, numColumns=1):
+    if not os.path.exists(filepath):
+        raise RuntimeError("Invalid filepath: {0}".format(filepath))
+
+    txtContents = numpy.loadtxt(filepath, dtype=expectedValues.dtype, delimiter=delimiter)
+    if numColumns > 1:
+        expectedValues = numpy.column_stack([expectedValues] * numColumns)
+    checkArrayContents(expectedValues, txtContents)
+
 #
 # Generating outputs
 #
@@ -93,6 +111,15 @@ def generate1DNpyFile(filepath, dtype):
     # Return values for validation
     return values
 
+# The values are stored as float16 but returned as float32, the type the
+# file sources output.
+def generate1DHalfPrecisionNpyFile(filepath):
+    values = generate1DRandomValues(numpy.dtype("float16"), 256)
+    numpy.save(filepath, values)
+
+    # Return values for validation
+    return values.astype("float32")
+
 def generate2DNpyFile(filepath, dtype):
     values = generate2DRandomValues(dtype, 4, 256)
     numpy.save(filepath, values)
@@ -100,6 +127,15 @@ def generate2DNpyFile(filepath, dtype):
     # Return values for validation
     return values
 
+# Each channel is written as a column, after a header line.
+def generate2DTxtFile(filepath, dtype, delimiter):
+    values = generate2DRandomValues(dtype, 4, 256)
+    fmt = "%.18e" if ("f" == values.dtype.kind) else "%d"
+    numpy.savetxt(filepath, values.T, fmt=fmt, delimiter=delimiter, header="header", comments="")
+
+    # Return values for validation
+    return values
+
 def generateNpzFile(filepath, compressed):
     values = dict()
     keys = [
@@ -110,11 +146,84 @@ def generateNpzFile(filepath, compressed):
     for key in keys:
         values[key+"_1D"] = generate1DRandomValues(numpy.dtype(key), 256)
         values[key+"_2D"] = generate2DRandomValues(numpy.dtype(key), 4, 256)
+        values[key+"_2D_F"] = generate2DRandomValues(numpy.dtype(key), 4, 256)
+
+    # Store some arrays in Fortran order, which the .npz source decodes as a
+    # stream of interleaved frames. The returned values stay C-ordered.
+    fileValues = {key: (numpy.asfortranarray(value) if key.endswith("_F") else value)
+                  for key,value in values.items()}
+
+    if compressed:
+        numpy.savez_compressed(filepath, **fileValues)
+    else:
+        numpy.savez(filepath, **fileValues)
+
+    # Return values for validation
+    return values
 
+# Large enough that the .npz source decodes it in several chunks
+def generateLargeNpzFile(filepath, key, compressed):
+    values = generate1DRandomValues(numpy.dtype("float64"), 400000)
     if compressed:
-        numpy.savez_compressed(filepath, **values)
+        numpy.savez_compressed(filepath, **{key: values})
     else:
-        numpy.savez(filepath, **values)
+        numpy.savez(filepath, **{key: values})
 
     # Return values for validation
     return values
+
+#
+# Thread pool
+#
+
+# Runs tiles over numElements elements on numThreads threads, and checks that
+# every element is processed exactly once, by as many workers as there are
+# threads, CPUs, or tiles, whichever is fewest. Each tile sleeps, releasing the
+# GIL, so every worker gets to claim one.
+def checkRunTiles(numElements, numThreads, tileElements):
+    counts = numpy.zeros(numElements, dtype="int64")
+    workers = set()
+    workersLock = threading.Lock()
+
+    def processTile(start, stop, worker):
+        counts[start:stop] += 1
+        with workersLock:
+            workers.add(worker)
+        time.sleep(0.001)
+
+    ThreadPool.runTiles(processTile, numElements, numThreads, tileElements)
+
+    if (counts != 1).any():
+        raise RuntimeError("Elements not processed exactly once: {0}".format(numpy.flatnonzero(counts != 1)))
+
+    numTiles = -(-numElements // tileElements)
+    expectedNumWorkers = max(1, min(ThreadPool.getUsableNumThreads(numThreads), numTiles))
+
+    if sorted(workers) != list(range(expectedNumWorkers)):
+        raise RuntimeError("Expected workers {0}. Actual workers {1}".format(list(range(expectedNumWorkers)), sorted(workers)))
+
+# Fills a buffer of several tiles from a normal random source with the given
+# number of threads, and checks that the values look like they came from
+# separately seeded generators.
+def checkThreadedRandomSource(numThreads):
+    # Without numpy.random.Generator, sources generate on a single thread.
+    if not hasattr(numpy.random, "Generator"):
+        return
+
+    from .BlockEntryPoints import Normal
+
+    block = Normal("float64", 0.0, 1.0)
+    block.setNumThreads(numThreads)
+
+    values = numpy.full(numThreads * 4 * Utility.ElementwiseTileElements, numpy.nan)
+    block.generateTiles(values)
+
+    if numpy.isnan(values).any():
+        raise RuntimeError("Not every value was generated.")
+    if (abs(values.mean()) > 0.05) or (abs(values.std() - 1.0) > 0.05):
+        raise RuntimeError("Unexpected statistics: mean {0}, standard deviation {1}".format(values.mean(), values.std()))
+
+    # Tiles from generators with the same seed would repeat each other.
+    tiles = values.reshape(-1, Utility.ElementwiseTileElements)
+    if len(set(tile[0] for tile in tiles)) != len(tiles):
+        raise RuntimeError("Tiles repeat each other.")
@@ -0,0 +1,317 @@
+# Copyright (c) 2019-2020 Nicholas Corgan
+# SPDX-License-Identifier: BSD-3-Clause
+
+from .BaseBlock import *
+
+from . import Utility
+
+import Pothos
+
+import io
+import numpy
+import os
+import warnings
+
+# Both blocks only support real types, as numpy.savetxt's complex output
+# can't always be read back by numpy.loadtxt.
+TextDTypeArgs = dict(supportInt=True, supportUInt=True, supportFloat=True)
+
+"""
+/*
+ * |PothosDoc Text File Source
+ *
+ * Stream columns of numbers from a delimited text file, such as a CSV file.
+ * Each column is sent to its own output port, matching the layout of
+ * <b>numpy.loadtxt(..., unpack=True)</b>.
+ *
+ * The file is read in fixed-size chunks, and each chunk is parsed with
+ * NumPy's native parser, so the whole file is never loaded into memory.
+ * The number of columns, and therefore output ports, is taken from the
+ * first line of data.
+ *
+ * Corresponding NumPy function: <b>numpy.loadtxt</b>
+ *
+ * |category /NumPy/File IO
+ * |category /File IO
+ * |category /Sources
+ * |keywords load text csv file IO
+ * |factory /numpy/loadtxt(filepath,dtype,delimiter,comments,skiprows,repeat)
+ * |setter setRepeat(repeat)
+ *
+ * |param filepath[Filepath]
+ * |widget FileEntry(mode=open)
+ * |default ""
+ * |preview enable
+ *
+ * |param dtype[Data Type] The output data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param delimiter[Delimiter] The string separating columns. An empty string means any whitespace.
+ * |widget StringEntry()
+ * |default ""
+ * |preview enable
+ *
+ * |param comments[Comments] Characters after this string on a line are ignored.
+ * |widget StringEntry()
+ * |default "#"
+ * |preview enable
+ *
+ * |param skiprows[Skip Rows] The number of lines to skip at the start of the file, such as a header.
+ * |widget SpinBox(minimum=0)
+ * |default 0
+ * |preview enable
+ *
+ * |param repeat[Repeat?]
+ * |widget ToggleSwitch(on="True",off="False")
+ * |default false
+ * |preview enable
+ */
+"""
+class TextFileSource(BaseBlock):
+    ChunkBytes = 4*1024*1024
+
+    def __init__(self, filepath, dtype, delimiter, comments, skiprows, repeat):
+        if not os.path.exists(filepath):
+            raise IOError("The given file does not exist: {0}".format(filepath))
+        if skiprows < 0:
+            raise ValueError("skiprows must be non-negative.")
+
+        dtype = Utility.toDType(dtype)
+        BaseBlock.__init__(self, "/numpy/loadtxt", numpy.loadtxt, None, dtype, None, TextDTypeArgs, list(), dict(), useDType=False)
+
+        self.__filepath = filepath
+        self.__delimiter = delimiter
+        self.__comments = comments
+        self.__skiprows = skiprows
+        self.__repeat = repeat
+
+        # The file is only kept open while the block is active.
+        with open(filepath, "r") as f:
+            self.__file = f
+            self.__rewind()
+            self.__numColumns = self.__countColumns()
+        self.__file = None
+
+        if 0 == self.__numColumns:
+            raise RuntimeError("The given file contains no data: {0}".format(filepath))
+
+        # Parsed values not yet output, one row per column.
+        self.__values = numpy.empty((self.__numColumns, 0), dtype=self.numpyOutputDType)
+        self.__offset = 0
+
+        for port in range(self.__numColumns):
+            self.setupOutput(port, dtype)
+
+    def activate(self):
+        self.__file = open(self.__filepath, "r")
+        self.__rewind()
+
+        self.__values = self.__values[:,:0]
+        self.__offset = 0
+
+    def deactivate(self):
+        if self.__file is not None:
+            self.__file.close()
+            self.__file = None
+
+    def filepath(self):
+        return self.__filepath
+
+    def delimiter(self):
+        return self.__delimiter
+
+    def comments(self):
+        return self.__comments
+
+    def skiprows(self):
+        return self.__skiprows
+
+    def numColumns(self):
+        return self.__numColumns
+
+    def repeat(self):
+        return self.__repeat
+
+    def setRepeat(self, repeat):
+        self.__repeat = repeat
+
+    def __rewind(self):
+        self.__file.seek(0)
+        self.__pending = ""
+        for _ in range(self.__skiprows):
+            self.__file.readline()
+
+    def __loadtxt(self, text):
+        # NumPy warns when given only comments or blank lines.
+        with warnings.catch_warnings():
+            warnings.simplefilter("ignore")
+            return self.func(
+                       io.StringIO(text),
+                       dtype=self.numpyOutputDType,
+                       delimiter=(self.__delimiter if self.__delimiter else None),
+                       comments=(self.__comments if self.__comments else None),
+                       ndmin=2)
+
+    def __parse(self, text):
+        values = self.__loadtxt(text)
+        if (values.size > 0) and (values.shape[1] != self.__numColumns):
+            raise RuntimeError("Expected {0} columns, found {1}.".format(self.__numColumns, values.shape[1]))
+
+        # One contiguous row per output port
+        return numpy.ascontiguousarray(values.T).reshape(self.__numColumns, -1)
+
+    def __countColumns(self):
+        for line in self.__file:
+            values = self.__loadtxt(line)
+            if values.size > 0:
+                self.__rewind()
+                return values.shape[1]
+
+        return 0
+
+    # Returns False at the end of the file.
+    def __readChunk(self):
+        text = self.__file.read(self.ChunkBytes)
+        if not text:
+            if self.__pending:
+                text = self.__pending + "\n"
+                self.__pending = ""
+            else:
+                return False
+        else:
+            # Only parse whole lines, and hold on to the rest for the next
+            # chunk.
+            text = self.__pending + text
+            lastNewline = text.rfind("\n")
+            self.__pending = text[(lastNewline+1):]
+            text = text[:(lastNewline+1)]
+
+        self.__values = self.__parse(text) if text else self.__values[:,:0]
+        self.__offset = 0
+        return True
+
+    def work(self):
+        if 0 == self.workInfo().minElements:
+            return
+
+        while self.__offset >= self.__values.shape[1]:
+            if not self.__readChunk():
+                if self.__repeat:
+                    self.__rewind()
+                else:
+                    return
+
+                # Don't loop forever if the file has no data left to repeat.
+                if not self.__readChunk():
+                    return
+
+        outputs = self.outputs()
+        n = min(len(outputs[0].buffer()), (self.__values.shape[1] - self.__offset))
+
+        for (values, output) in zip(self.__values, outputs):
+            output.buffer()[:n] = values[self.__offset:(self.__offset+n)]
+            output.produce(n)
+
+        self.__offset += n
+
+"""
+/*
+ * |PothosDoc Text File Sink
+ *
+ * Write each input port as a column of a delimited text file, such as a CSV
+ * file, matching the layout of <b>numpy.savetxt</b>. Values are written as
+ * they arrive, so the file never has to be held in memory.
+ *
+ * Corresponding NumPy function: <b>numpy.savetxt</b>
+ *
+ * |category /NumPy/File IO
+ * |category /File IO
+ * |category /Sinks
+ * |keywords save text csv file IO
+ * |factory /numpy/savetxt(filepath,dtype,nchans,delimiter,fmt)
+ *
+ * |param filepath[Filepath]
+ * |widget FileEntry(mode=save)
+ * |default ""
+ * |preview enable
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param nchans[Num Channels] The number of inputs, each written as a column.
+ * |widget SpinBox(minimum=1)
+ * |default 1
+ * |preview disable
+ *
+ * |param delimiter[Delimiter] The string separating columns.
+ * |widget StringEntry()
+ * |default " "
+ * |preview enable
+ *
+ * |param fmt[Format] A printf-style format for each value. If empty, integers are written with
+ * <b>%d</b> and floating-point values with NumPy's default <b>%.18e</b>, which reads back exactly.
+ * |widget StringEntry()
+ * |default ""
+ * |preview enable
+ */
+"""
+class TextFileSink(BaseBlock):
+    def __init__(self, filepath, dtype, nchans, delimiter, fmt):
+        if nchans < 1:
+            raise ValueError("nchans must be at least 1.")
+
+        dtype = Utility.toDType(dtype)
+        BaseBlock.__init__(self, "/numpy/savetxt", numpy.savetxt, dtype, None, TextDTypeArgs, None, list(), dict(), useDType=False)
+
+        if not fmt:
+            fmt = "%.18e" if ("f" == self.numpyInputDType.kind) else "%d"
+
+        self.__filepath = filepath
+        self.__nchans = nchans
+        self.__delimiter = delimiter
+        self.__fmt = fmt
+        # The delimiter is part of the format string, so escape any % in it.
+        self.__rowFormat = delimiter.replace("%", "%%").join([fmt] * nchans) + "\n"
+        self.__file = None
+
+        for chan in range(nchans):
+            self.setupInput(chan, dtype)
+
+    def activate(self):
+        self.__file = open(self.__filepath, "w")
+
+    def deactivate(self):
+        if self.__file is not None:
+            self.__file.close()
+            self.__file = None
+
+    def filepath(self):
+        return self.__filepath
+
+    def nchans(self):
+        return self.__nchans
+
+    def delimiter(self):
+        return self.__delimiter
+
+    def fmt(self):
+        return self.__fmt
+
+    def work(self):
+        elems = self.workInfo().minAllInElements
+        if 0 == elems:
+            return
+
+        inputs = self.inputs()
+        values = numpy.column_stack([port.buffer()[:elems] for port in inputs])
+
+        # Formatting the whole chunk with one format string is much faster
+        # than numpy.savetxt's per-row formatting, and gives the same output.
+        self.__file.write((self.__rowFormat * elems) % tuple(values.ravel().tolist()))
+
+        for port in inputs:
+            port.consume(elems)
@@ -0,0 +1,218 @@
+# Copyright (c) 2019-2020 Nicholas Corgan
+# SPDX-License-Identifier: BSD-3-Clause
+
+from . import Utility
+
+import concurrent.futures
+import itertools
+import json
+import os
+import threading
+import weakref
+
+# Used to control the thread pools of NumPy's BLAS library, if available
+try:
+    import threadpoolctl
+    BackendController = threadpoolctl.ThreadpoolController()
+except (ImportError, AttributeError):
+    BackendController = None
+
+#
+# Shared thread pool for tiled execution
+#
+# NumPy releases the GIL in its element-wise loops and random distributions,
+# so large buffers can be split into tiles and processed on several threads.
+# Blocks with the same CPU affinity share one pool sized to it, and the thread
+# calling work() always processes tiles itself, so a busy pool slows a block
+# down rather than stalling it.
+#
+# Only buffers larger than a tile are split. The default buffer manager's
+# 8 KiB buffers hold at most a tile, so blocks that split their input post
+# their own output buffers rather than writing to the given ones. This only
+# helps when upstream hands a block more than a tile at once, which happens
+# when the upstream block posts large buffers (file sources, other threaded
+# blocks) or the block falls behind and its input is accumulated. Threads
+# don't help in a topology of default buffers throughout.
+#
+
+# The number of threads blocks use when not set per block. Tiling is opt-in,
+# so this is 1 unless POTHOS_NUMPY_NUM_THREADS is set.
+DefaultNumThreads = max(1, int(os.environ.get("POTHOS_NUMPY_NUM_THREADS", "1")))
+
+MaxNumThreads = os.cpu_count() or 1
+
+# The CPUs the calling thread may run on. Pothos thread pools with an affinity
+# set their worker threads', so this gives the CPUs of the pool calling work().
+# None if the platform doesn't support affinities.
+def getAffinity():
+    if hasattr(os, "sched_getaffinity"):
+        return frozenset(os.sched_getaffinity(0))
+
+    return None
+
+# One executor per affinity, whose threads are pinned to it, so tiles run on
+# the same CPUs as the block calling work().
+SharedExecutors = dict()
+SharedExecutorLock = threading.Lock()
+
+def defaultNumThreads():
+    return DefaultNumThreads
+
+def setDefaultNumThreads(numThreads):
+    global DefaultNumThreads
+
+    if numThreads < 1:
+        raise ValueError("numThreads must be at least 1.")
+
+    DefaultNumThreads = numThreads
+
+def getSharedExecutor(affinity):
+    with SharedExecutorLock:
+        executor = SharedExecutors.get(affinity)
+        if executor is None:
+            if affinity is None:
+                executor = concurrent.futures.ThreadPoolExecutor(MaxNumThreads, thread_name_prefix="PothosNumPy")
+            else:
+                executor = concurrent.futures.ThreadPoolExecutor(
+                               len(affinity),
+                               thread_name_prefix="PothosNumPy",
+                               initializer=os.sched_setaffinity,
+                               initargs=(0, affinity))
+            SharedExecutors[affinity] = executor
+
+        return executor
+
+# The number of threads tiles can run on, capped by the CPUs the calling thread
+# may run on
+def getUsableNumThreads(numThreads, affinity=None):
+    if affinity is None:
+        affinity = getAffinity()
+
+    return min(numThreads, MaxNumThreads if (affinity is None) else len(affinity))
+
+# Calls func(start, stop, worker) over tiles covering [0, numElements). Each
+# worker claims the next unprocessed tile when it finishes one, so a slow tile
+# doesn't hold up the others. worker is in [0, numThreads), and no two calls
+# with the same worker run at once. Small buffers, or numThreads of 1, result
+# in a single call over the whole range.
+def runTiles(func, numElements, numThreads, tileElements=Utility.ElementwiseTileElements):
+    affinity = getAffinity()
+    numThreads = getUsableNumThreads(numThreads, affinity)
+    if (numThreads <= 1) or (numElements <= tileElements):
+        func(0, numElements, 0)
+        return
+
+    tiles = [(start, min(start + tileElements, numElements)) for start in range(0, numElements, tileElements)]
+    numWorkers = min(numThreads, len(tiles))
+    nextTile = itertools.count()
+
+    def processTiles(worker):
+        while True:
+            # next() on a shared counter is atomic under the GIL.
+            index = next(nextTile)
+            if index >= len(tiles):
+                return
+            func(tiles[index][0], tiles[index][1], worker)
+
+    executor = getSharedExecutor(affinity)
+    futures = [executor.submit(processTiles, worker) for worker in range(1, numWorkers)]
+    processTiles(0)
+
+    # Every tile has been claimed, so workers that haven't started yet have
+    # nothing to do, and only the running ones need to finish.
+    for future in futures:
+        if not future.cancel():
+            future.result()
+
+#
+# Backend thread limits
+#
+# NumPy's BLAS library (OpenBLAS, MKL, etc) has its own thread pool, which
+# competes with the Pothos thread pools and the pool above for cores. This
+# count is process-wide, so it is set to the smallest of the global limit and
+# the limits of every block that has one. A limit of 0 leaves the backend's
+# own setting.
+#
+
+GlobalBackendNumThreads = 0
+BlockBackendNumThreads = dict()
+AppliedBackendNumThreads = 0
+BackendLimiter = None
+BackendLock = threading.Lock()
+
+def isBackendControlAvailable():
+    return (BackendController is not None)
+
+def getBackendInfo():
+    return BackendController.info() if (BackendController is not None) else []
+
+def validateBackendNumThreads(numThreads):
+    if numThreads < 0:
+        raise ValueError("numThreads cannot be negative.")
+    if (numThreads > 0) and (BackendController is None):
+        raise RuntimeError("Limiting NumPy's backend threads requires the threadpoolctl module (3.0+).")
+
+# Must be called with BackendLock held.
+def applyBackendLimits():
+    global AppliedBackendNumThreads
+    global BackendLimiter
+
+    limits = [numThreads for numThreads in list(BlockBackendNumThreads.values()) + [GlobalBackendNumThreads] if numThreads > 0]
+    numThreads = min(limits) if limits else 0
+    if numThreads == AppliedBackendNumThreads:
+        return
+
+    if numThreads > 0:
+        limiter = BackendController.limit(limits=numThreads)
+
+        # The first limiter knows the backend's original settings.
+        if BackendLimiter is None:
+            BackendLimiter = limiter
+    else:
+        BackendLimiter.restore_original_limits()
+        BackendLimiter = None
+
+    AppliedBackendNumThreads = numThreads
+
+def backendNumThreads():
+    return GlobalBackendNumThreads
+
+def setBackendNumThreads(numThreads):
+    global GlobalBackendNumThreads
+
+    validateBackendNumThreads(numThreads)
+    with BackendLock:
+        GlobalBackendNumThreads = numThreads
+        applyBackendLimits()
+
+def removeBlockBackendNumThreads(blockID):
+    with BackendLock:
+        if BlockBackendNumThreads.pop(blockID, None) is not None:
+            applyBackendLimits()
+
+# A block's limit applies until it is set to 0 or the block is destroyed.
+def setBlockBackendNumThreads(block, numThreads):
+    validateBackendNumThreads(numThreads)
+
+    blockID = id(block)
+    with BackendLock:
+        isNew = (blockID not in BlockBackendNumThreads)
+        if numThreads > 0:
+            BlockBackendNumThreads[blockID] = numThreads
+        else:
+            BlockBackendNumThreads.pop(blockID, None)
+        applyBackendLimits()
+
+    if isNew and (numThreads > 0):
+        weakref.finalize(block, removeBlockBackendNumThreads, blockID)
+
+def getThreadInfoJSONString():
+    topLevel = dict()
+    topLevel["Thread Info"] = dict()
+    topLevel["Thread Info"]["Default Num Threads"] = DefaultNumThreads
+    topLevel["Thread Info"]["Max Num Threads"] = MaxNumThreads
+    topLevel["Thread Info"]["Backend Num Threads Limit"] = AppliedBackendNumThreads
+    topLevel["Thread Info"]["Backend Control Available"] = isBackendControlAvailable()
+    topLevel["Thread Info"]["Backends"] = getBackendInfo()
+
+    return json.dumps(topLevel)
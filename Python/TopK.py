@@ -0,0 +1,277 @@
+# Copyright (c) 2019-2020 Nicholas Corgan
+# SPDX-License-Identifier: BSD-3-Clause
+
+from .BaseBlock import *
+from . import Utility
+
+import Pothos
+
+import numpy
+
+#
+# Streaming top-K selection
+#
+# The K largest (or smallest) values seen so far are kept with their indices
+# in the stream, and are output every interval input values. Only values that
+# beat the worst kept value can change the result, so each buffer is first
+# filtered with one comparison, and the few values left are selected from
+# along with the kept ones with numpy.partition.
+#
+
+class TopKBlock(BaseBlock):
+    def __init__(self, dtype, k, order, interval, outputMode):
+        dtype = Utility.toDType(dtype)
+        dtypeArgs = dict(supportInt=True, supportUInt=True, supportFloat=True)
+
+        if k < 1:
+            raise ValueError("k must be at least 1.")
+        if order not in ["LARGEST", "SMALLEST"]:
+            raise ValueError("Invalid order: {0}. Valid values: LARGEST, SMALLEST".format(order))
+        if interval < 1:
+            raise ValueError("interval must be at least 1.")
+        if outputMode not in ["VECTOR", "LABEL"]:
+            raise ValueError("Invalid output mode: {0}. Valid values: VECTOR, LABEL".format(outputMode))
+
+        self.__k = k
+        self.__order = order
+        self.__interval = interval
+        self.__outputMode = outputMode
+
+        outputDType = Utility.DType(dtype.name(), k) if (outputMode == "VECTOR") else dtype
+        outputDTypeArgs = dict(dtypeArgs, supportVector=True)
+        BaseBlock.__init__(self, "/numpy/top_k", None, dtype, outputDType, dtypeArgs, outputDTypeArgs, list(), dict(), useDType=False)
+
+        self.setupInput(0, self.inputDType)
+        if outputMode == "VECTOR":
+            self.setupOutput(0, self.outputDType)
+            self.setupOutput(1, Utility.DType("int64", k))
+        else:
+            # Unique domain because of buffer forwarding
+            self.setupOutput(0, self.outputDType, self.uid())
+
+        self.registerProbe("k")
+        self.registerProbe("order")
+        self.registerProbe("interval")
+        self.registerProbe("outputMode")
+        self.registerProbe("values")
+        self.registerProbe("indices")
+        self.registerSlot("reset")
+
+        self.reset()
+
+    def k(self):
+        return self.__k
+
+    def order(self):
+        return self.__order
+
+    def interval(self):
+        return self.__interval
+
+    def outputMode(self):
+        return self.__outputMode
+
+    # Best first
+    def values(self):
+        return self.__values.tolist()
+
+    def indices(self):
+        return self.__indices.tolist()
+
+    def reset(self):
+        self.__values = numpy.zeros(0, dtype=self.numpyInputDType)
+        self.__indices = numpy.zeros(0, dtype=numpy.int64)
+        self.__numValues = 0
+        self.__numSinceOutput = 0
+
+    # Adds values starting at the given stream index, and keeps the best K.
+    def __select(self, values, firstIndex):
+        indices = numpy.arange(firstIndex, firstIndex + len(values), dtype=numpy.int64)
+
+        # NaNs have no place in the order.
+        if values.dtype.kind == "f":
+            isNumber = ~numpy.isnan(values)
+            values = values[isNumber]
+            indices = indices[isNumber]
+
+        # Once K values are kept, only better ones matter.
+        if len(self.__values) == self.__k:
+            if self.__order == "LARGEST":
+                isBetter = values > self.__values[-1]
+            else:
+                isBetter = values < self.__values[-1]
+
+            values = values[isBetter]
+            indices = indices[isBetter]
+
+        if 0 == len(values):
+            return
+
+        values = numpy.concatenate([self.__values, values])
+        indices = numpy.concatenate([self.__indices, indices])
+
+        if len(values) > self.__k:
+            # Everything better than the Kth best value is kept, along with
+            # the earliest of the values equal to it.
+            if self.__order == "LARGEST":
+                kthBest = numpy.partition(values, len(values) - self.__k)[len(values) - self.__k]
+                better = numpy.flatnonzero(values > kthBest)
+            else:
+                kthBest = numpy.partition(values, self.__k - 1)[self.__k - 1]
+                better = numpy.flatnonzero(values < kthBest)
+
+            ties = numpy.flatnonzero(values == kthBest)
+            numTies = self.__k - len(better)
+            if len(ties) > numTies:
+                ties = ties[numpy.argpartition(indices[ties], numTies - 1)[:numTies]]
+
+            best = numpy.concatenate([better, ties])
+            values = values[best]
+            indices = indices[best]
+
+        # Only the K kept values are sorted, best first, with ties in stream
+        # order.
+        if self.__order == "LARGEST":
+            sortOrder = numpy.lexsort((-indices, values))[::-1]
+        else:
+            sortOrder = numpy.lexsort((indices, values))
+
+        self.__values = values[sortOrder]
+        self.__indices = indices[sortOrder]
+
+    # Returns the indices of the values after which outputs are due, along
+    # with the kept values and their stream indices at those times.
+    def __processValues(self, values):
+        outputIndices = []
+        outputs = []
+
+        start = 0
+        while start < len(values):
+            stop = min(len(values), start + (self.__interval - self.__numSinceOutput))
+
+            self.__select(values[start:stop], self.__numValues + start)
+
+            self.__numSinceOutput += (stop - start)
+            start = stop
+
+            if self.__numSinceOutput == self.__interval:
+                outputIndices.append(stop - 1)
+                outputs.append((self.__values.copy(), self.__indices.copy()))
+                self.__numSinceOutput = 0
+
+        self.__numValues += len(values)
+
+        return (outputIndices, outputs)
+
+    def work(self):
+        if self.__outputMode == "VECTOR":
+            self.workVector()
+        else:
+            self.workLabel()
+
+    def workVector(self):
+        in0 = self.input(0).buffer()
+
+        # A K of 1 gives scalar outputs.
+        valuesOut = self.output(0).buffer().reshape((-1, self.__k))
+        indicesOut = self.output(1).buffer().reshape((-1, self.__k))
+
+        maxOutputs = min(len(valuesOut), len(indicesOut))
+        if (0 == len(in0)) or (0 == maxOutputs):
+            return
+
+        # Only take as many values as there's room for the outputs of.
+        numValues = min(len(in0), (maxOutputs * self.__interval) - self.__numSinceOutput)
+        (_, outputs) = self.__processValues(self.toNumPyInput(in0[:numValues]))
+
+        self.input(0).consume(numValues)
+        if not outputs:
+            return
+
+        # Until K values have been seen, the rest of each output is padded
+        # with an index of -1.
+        for (outputIndex, (values, indices)) in enumerate(outputs):
+            valuesOut[outputIndex] = 0
+            valuesOut[outputIndex][:len(values)] = values
+            indicesOut[outputIndex] = -1
+            indicesOut[outputIndex][:len(indices)] = indices
+
+        self.output(0).produce(len(outputs))
+        self.output(1).produce(len(outputs))
+
+    def workLabel(self):
+        if 0 == self.input(0).elements():
+            return
+
+        buf = self.input(0).takeBuffer()
+        (outputIndices, outputs) = self.__processValues(self.toNumPyInput(buf))
+
+        self.input(0).consume(len(buf))
+        for (index, (values, indices)) in zip(outputIndices, outputs):
+            self.output(0).postLabel(Pothos.Label("TOP_K", values.tolist(), index))
+            self.output(0).postLabel(Pothos.Label("TOP_K_INDICES", indices.tolist(), index))
+        self.output(0).postBuffer(buf)
+
+#
+# Factories exposed to C++ layer
+#
+
+"""
+/*
+ * |PothosDoc Top K
+ *
+ * Track the <b>k</b> largest or smallest values in the input stream, along
+ * with their indices in the stream, and output them every <b>interval</b>
+ * input values.
+ *
+ * The values are kept across buffers until the block is reset, using memory
+ * that depends only on <b>k</b>. Each buffer is first filtered down to the
+ * values that beat the worst kept value, so most values are only compared
+ * once. Values are output best first, and NaNs are ignored.
+ *
+ * Unlike <b>/numpy/partition</b>, which partitions each buffer on its own,
+ * the result covers the whole stream.
+ *
+ * |category /NumPy/Stats
+ * |keywords top k largest smallest max min peak partition select
+ * |factory /numpy/top_k(dtype,k,order,interval,outputMode)
+ *
+ * |param dtype[Data Type] The block data type.
+ * |widget DTypeChooser(int=1,uint=1,float=1)
+ * |default "float64"
+ * |preview disable
+ *
+ * |param k[K] The number of values to keep.
+ * |widget SpinBox(minimum=1)
+ * |default 10
+ * |preview enable
+ *
+ * |param order[Order]
+ * |widget ComboBox(editable=False)
+ * |default "LARGEST"
+ * |option [Largest] "LARGEST"
+ * |option [Smallest] "SMALLEST"
+ * |preview enable
+ *
+ * |param interval[Interval] The number of input values between outputs.
+ * |widget SpinBox(minimum=1)
+ * |default 8192
+ * |preview enable
+ *
+ * |param outputMode[Output Mode] How values and indices are output.
+ * <ul>
+ * <li><b>VECTOR</b>: the values as vector elements of size <b>k</b> on port 0,
+ * and their indices as <b>int64</b> vector elements on port 1. Until <b>k</b>
+ * values have been seen, the rest of each output is padded with an index of -1.</li>
+ * <li><b>LABEL</b>: as <b>"TOP_K"</b> and <b>"TOP_K_INDICES"</b> labels on the
+ * forwarded input, at the last value counted.</li>
+ * </ul>
+ * |widget ComboBox(editable=False)
+ * |default "VECTOR"
+ * |option [Vector] "VECTOR"
+ * |option [Label] "LABEL"
+ * |preview disable
+ */
+"""
+def TopK(dtype, k, order, interval, outputMode):
+    return TopKBlock(dtype, k, order, interval, outputMode)
@@ -2,6 +2,7 @@
 # SPDX-License-Identifier: BSD-3-Clause
 
 from .BaseBlock import *
+from . import ThreadPool
 
 import Pothos
 
@@ -16,10 +17,24 @@ class TwoToOneBlock(BaseBlock):
 
         BaseBlock.__init__(self, blockPath, func, inputDType, outputDType, inputDTypeArgs, outputDTypeArgs, funcArgs, funcKWargs, *args, **kwargs)
 
+        # Element-wise blocks are marked as such in their YAML entries.
+        self.isElementwise = kwargs.get("elementwise", False)
+
         self.setupInput(0, self.inputDType)
         self.setupInput(1, self.inputDType)
         self.setupOutput(0, self.outputDType)
 
+    # Returns the result of this block's function on the given values, without
+    # converting to the output type.
+    def evaluate(self, values0, values1):
+        values0 = self.toNumPyInput(values0)
+        values1 = self.toNumPyInput(values1)
+
+        if self.useDType:
+            return self.func(values0, values1, *self.funcArgs, dtype=self.numpyInputDType)
+        else:
+            return self.func(values0, values1, *self.funcArgs)
+
     def work(self):
         assert(self.numpyInputDType is not None)
         assert(self.numpyOutputDType is not None)
@@ -34,8 +49,8 @@ class TwoToOneBlock(BaseBlock):
         if 0 == elems:
             return
 
-        in0 = self.input(0).buffer()
-        in1 = self.input(1).buffer()
+        in0 = self.toNumPyInput(self.input(0).buffer())
+        in1 = self.toNumPyInput(self.input(1).buffer())
 
         N = min(len(in0), len(in1))
         out = None
@@ -43,15 +58,15 @@ class TwoToOneBlock(BaseBlock):
         if self.useDType:
             out = self.func(in0[:N], in1[:N], *self.funcArgs, dtype=self.numpyInputDType)
         else:
-            out = self.func(in0[:N], in1[:N], *self.funcArgs).astype(self.numpyOutputDType)
+            out = self.func(in0[:N], in1[:N], *self.funcArgs).astype(self.numpyOutputDType, copy=False)
 
         if (out is not None) and (len(out) > 0):
             self.input(0).consume(elems)
             self.input(1).consume(elems)
-            self.output(0).postBuffer(out)
+            self.output(0).postBuffer(self.fromNumPyOutput(out))
 
     def workWithGivenOutputBuffer(self):
-        elems = self.workInfo().minAllElements
+        elems = self.workInfo().minAllInElements
         if 0 == elems:
             return
 
@@ -62,13 +77,30 @@ class TwoToOneBlock(BaseBlock):
         N = min(len(in0), len(in1), len(out0))
         out = None
 
-        if self.useDType:
-            out = self.func(in0[:N], in1[:N], *self.funcArgs, dtype=self.numpyInputDType)
-        else:
-            out = self.func(in0[:N], in1[:N], *self.funcArgs)
+        if self.complexIntPairFunc is not None:
+            self.callComplexIntPairFunc([in0[:N], in1[:N]], out0[:N])
+            self.input(0).consume(N)
+            self.input(1).consume(N)
+            self.output(0).produce(N)
+            return
+
+        if self.isElementwise:
+            (outBuf, isPosted) = self.getTiledOutputBuffer(min(len(in0), len(in1)))
+            N = len(outBuf)
+
+            def processTile(start, stop, worker):
+                self.writeOutput(outBuf[start:stop], self.evaluate(in0[start:stop], in1[start:stop]))
+
+            ThreadPool.runTiles(processTile, N, self.numThreads())
+            self.input(0).consume(N)
+            self.input(1).consume(N)
+            self.finishTiledOutput(outBuf, isPosted)
+            return
+
+        out = self.evaluate(in0[:N], in1[:N])
 
         if (out is not None) and (len(out) > 0):
-            out0[:N] = out
+            self.writeOutput(out0[:N], out)
 
             self.input(0).consume(N)
             self.input(1).consume(N)
@@ -3,6 +3,7 @@
 
 import Pothos
 
+import mmap
 import numpy
 
 def DType(*args):
@@ -19,19 +20,26 @@ def toDType(dtypeInput):
     else:
         raise TypeError("Invalid input: {0}".format(type(dtypeInput)))
 
+def isComplexIntDType(dtype):
+    return ("complex_i" in dtype.toString())
+
 # Pothos supports all complex types, but NumPy does not support
-# complex integral types, so we must catch this on block instantiation.
-# Also confirm that the given DType is 1-dimensional, as that is all
-# these blocks support.
+# complex integral types, so we must catch this on block instantiation
+# for blocks that don't handle them explicitly. Also confirm that the given
+# DType is 1-dimensional, unless the block processes each element of a vector
+# DType as a frame.
 def validateDType(dtype, dtypeArgs):
     typeStr = dtype.toString()
-    if ("complex_u" in typeStr) or ("complex_i" in typeStr) or dtype.isCustom():
+    isComplexInt = isComplexIntDType(dtype)
+    if ("complex_u" in typeStr) or dtype.isCustom() or (isComplexInt and not dtypeArgs.get("supportCInt", False)):
         raise TypeError("NumPy does not support type {0}".format(typeStr))
 
-    if dtype.dimension() > 1:
-        raise TypeError("PothosNumPy only supports DTypes of dimension 1.")
+    if (dtype.dimension() > 1) and not dtypeArgs.get("supportVector", False):
+        raise TypeError("This block only supports DTypes of dimension 1.")
+    if (dtype.dimension() > 1) and isComplexInt:
+        raise TypeError("Complex integer DTypes must be of dimension 1.")
 
-    if dtypeArgs.get("supportAll", False):
+    if dtypeArgs.get("supportAll", False) or isComplexInt:
         return
 
     UNSUPPORTED_TEMPLATE = "{0} types are not supported."
@@ -49,6 +57,237 @@ def validateDType(dtype, dtypeArgs):
     if unsupportedType is not None:
         raise TypeError(UNSUPPORTED_TEMPLATE.format(unsupportedType))
 
+#
+# Complex integer support
+#
+# NumPy has no complex integer types, so complex integer buffers are handled
+# as interleaved (real, imaginary) integer pairs. Operations that can work on
+# the pairs directly keep the data in this format, and everything else widens
+# it to the smallest complex float type that holds it exactly.
+#
+
+def complexIntScalarDType(dtype):
+    if (dtype is None) or not isComplexIntDType(dtype):
+        return None
+
+    return numpy.dtype(dtype.name().replace("complex_", ""))
+
+def complexIntWorkingDType(intDType):
+    return numpy.dtype("complex64") if (intDType.itemsize <= 2) else numpy.dtype("complex128")
+
+# Use in place of Pothos.Buffer.dtype_to_numpy() to get the type blocks process
+# data as. For vector DTypes, this is the type of each value in the vector, as
+# the buffers are given to blocks as (frames, dimension) arrays.
+def dtypeToNumPy(dtype):
+    intDType = complexIntScalarDType(dtype)
+    if intDType is not None:
+        return complexIntWorkingDType(intDType)
+
+    return Pothos.Buffer.dtype_to_numpy(dtype).base
+
+# Complex integer to complex float, but leaves other types alone
+def dtypeToComplexFloat(dtype):
+    intDType = complexIntScalarDType(dtype)
+    if intDType is not None:
+        return DType("complex_float32" if (intDType.itemsize <= 2) else "complex_float64", dtype.dimension())
+
+    return dtypeToComplex(dtype)
+
+# Returns an (N, 2) view of the given buffer's integer pairs.
+def complexIntPairs(arr, intDType):
+    return arr.view(intDType).reshape(-1, 2)
+
+def complexIntToComplexFloat(arr, intDType):
+    pairs = complexIntPairs(arr, intDType)
+    out = numpy.empty(len(pairs), complexIntWorkingDType(intDType))
+    out.view(out.real.dtype).reshape(-1, 2)[:] = pairs
+
+    return out
+
+# Rounds to the nearest integer and saturates. If out is None, the pairs are
+# returned as a new (N, 2) array.
+def complexFloatToComplexInt(values, intDType, out=None):
+    values = numpy.ascontiguousarray(values, dtype=numpy.result_type(values, numpy.complex64))
+    floats = numpy.rint(values.view(values.real.dtype).reshape(-1, 2))
+    numpy.clip(floats, *getSaturationBounds(floats.dtype, intDType), out=floats)
+
+    pairs = numpy.empty(floats.shape, intDType) if (out is None) else complexIntPairs(out, intDType)
+    numpy.copyto(pairs, floats, casting="unsafe")
+
+    return pairs
+
+# Integer pair arithmetic saturates at the limits of the integer type, like
+# the results of operations done on widened values. The results are
+# calculated before anything is written, so out may be an input. Only signed
+# pairs get here, as validateDType() rejects complex_u* types.
+
+def saturateComplexIntOverflows(results, overflows, positive):
+    info = numpy.iinfo(results.dtype)
+    results[overflows] = numpy.where(positive[overflows], info.max, info.min)
+
+    return results
+
+def complexIntAdd(lhs, rhs, out):
+    results = numpy.add(lhs, rhs)
+    overflows = ((lhs < 0) == (rhs < 0)) & ((results < 0) != (lhs < 0))
+
+    out[:] = saturateComplexIntOverflows(results, overflows, (lhs >= 0))
+
+def complexIntSubtract(lhs, rhs, out):
+    results = numpy.subtract(lhs, rhs)
+    overflows = ((lhs < 0) != (rhs < 0)) & ((results < 0) != (lhs < 0))
+
+    out[:] = saturateComplexIntOverflows(results, overflows, (lhs >= 0))
+
+def complexIntNegative(pairs, out):
+    results = numpy.negative(pairs)
+    out[:] = saturateComplexIntOverflows(results, (pairs == numpy.iinfo(pairs.dtype).min), (pairs < 0))
+
+def complexIntConjugate(pairs, out):
+    imag = numpy.empty(pairs[:,1].shape, dtype=pairs.dtype)
+    complexIntNegative(pairs[:,1], out=imag)
+
+    out[:,0] = pairs[:,0]
+    out[:,1] = imag
+
+# NumPy functions that can be calculated on integer pairs, mapped to the
+# function to call on the pairs
+ComplexIntPairFuncs = {
+    numpy.add: complexIntAdd,
+    numpy.subtract: complexIntSubtract,
+    numpy.negative: complexIntNegative,
+    numpy.conjugate: complexIntConjugate
+}
+
+def scalarDType(numpyDType):
+    return numpy.dtype(numpyDType.char.lower()) if ("c" == numpyDType.kind) else numpyDType
+
+# Returns the (min, max) range, in terms of the input type, that input values
+# must be clipped to in order to fit in the output type, or None if every
+# input value already fits.
+def getSaturationBounds(inputDType, outputDType):
+    inputDType = scalarDType(numpy.dtype(inputDType))
+    outputDType = scalarDType(numpy.dtype(outputDType))
+
+    if outputDType.kind in "iu":
+        outInfo = numpy.iinfo(outputDType)
+        if inputDType.kind in "iu":
+            inInfo = numpy.iinfo(inputDType)
+            if (inInfo.min >= outInfo.min) and (inInfo.max <= outInfo.max):
+                return None
+
+            return (inputDType.type(max(inInfo.min, outInfo.min)), inputDType.type(min(inInfo.max, outInfo.max)))
+        else:
+            # The integer limits may not be exactly representable as floats,
+            # so step inward until they convert back in range.
+            lo = inputDType.type(outInfo.min)
+            hi = inputDType.type(outInfo.max)
+            while int(lo) < outInfo.min:
+                lo = numpy.nextafter(lo, inputDType.type(0))
+            while int(hi) > outInfo.max:
+                hi = numpy.nextafter(hi, inputDType.type(0))
+
+            return (lo, hi)
+    elif (inputDType.kind == "f") and (numpy.finfo(inputDType).max > numpy.finfo(outputDType).max):
+        outMax = numpy.finfo(outputDType).max
+        return (inputDType.type(-outMax), inputDType.type(outMax))
+
+    # Integers always fit in a floating-point type, if not exactly.
+    return None
+
+# The number of elements blocks that evaluate several element-wise steps
+# process at a time. With a handful of intermediate arrays, this keeps the
+# working set within a typical L2 cache.
+ElementwiseTileElements = 8192
+
+# NumPy only guarantees alignment for its SIMD loops, so work buffers meant to
+# be reused are aligned to a cache line.
+CacheLineBytes = 64
+
+def alignedEmpty(shape, dtype, alignment=CacheLineBytes):
+    dtype = numpy.dtype(dtype)
+    numBytes = int(numpy.prod(shape)) * dtype.itemsize
+
+    raw = numpy.empty(numBytes + alignment, dtype=numpy.uint8)
+    offset = (-raw.ctypes.data) % alignment
+
+    return raw[offset:offset+numBytes].view(dtype).reshape(shape)
+
+# Copies the given values into a new Pothos::BufferChunk. NumPy arrays are
+# copied into one every time they're posted, so values posted repeatedly can
+# be converted once and the chunk posted instead.
+def toBufferChunk(values, dtype):
+    env = Pothos.ProxyEnvironment("managed")
+    chunk = env.findProxy("Pothos/BufferChunk")(dtype, len(values))
+    Pothos.Buffer.pointer_to_ndarray(chunk.address, len(values), values.dtype, readonly=False)[:] = values
+
+    return chunk
+
+#
+# Fast math
+#
+# The casts to and from single precision cost about as much as most of
+# NumPy's double-precision kernels, so this only pays off for functions whose
+# double-precision kernels are much slower than their single-precision ones.
+# With NumPy 2.4 on AVX-512, sin and cos were the only such functions, at
+# about 1.6x faster for 1024 values and 4x faster for 8192. Every other
+# function with known error bounds was slower (exp: 2.0us vs 8.7us for 1024
+# values), so only sin and cos offer FAST precision.
+#
+
+FastMathDTypes = {
+    numpy.dtype("float64"): numpy.dtype("float32"),
+    numpy.dtype("complex128"): numpy.dtype("complex64")
+}
+
+# The block's error bounds hold for every real input in [low, high], including
+# ones whose results are too small for single precision, and nothing in it
+# overflows, so buffers within it skip the check over every result.
+def evaluateFastMath(func, values, fastDType, low, high):
+    if (values.dtype.kind == "f") and (values.size > 0) and (values.min() >= low) and (values.max() <= high):
+        return func(values.astype(fastDType)).astype(values.dtype)
+
+    with numpy.errstate(over="ignore", under="ignore", invalid="ignore"):
+        out = func(values.astype(fastDType)).astype(values.dtype)
+
+    # Results that overflow or underflow in single precision (or are NaN) are
+    # recomputed in full precision.
+    finfo = numpy.finfo(fastDType)
+    magnitudes = numpy.abs(out)
+    recompute = ~((magnitudes >= finfo.tiny) & (magnitudes <= finfo.max))
+    if recompute.any():
+        out[recompute] = func(values[recompute])
+
+    return out
+
+#
+# Half-precision storage
+#
+# Pothos has no half-precision DType, so float16 is only used for data at
+# rest. Streams carry these values as float32, which holds every float16
+# value exactly. NumPy's casts between the two use F16C or AVX-512
+# instructions on CPUs that have them.
+#
+
+HalfPrecisionDType = numpy.dtype("float16")
+
+# The native-endian NumPy type a stream of values stored as the given type is
+# output as
+def streamNumPyDType(numpyDType):
+    numpyDType = numpy.dtype(numpyDType).newbyteorder("=")
+    return numpy.dtype("float32") if (HalfPrecisionDType == numpyDType) else numpyDType
+
+# An empty string means to store values as their stream type.
+def getStorageDType(storageDType, numpyStreamDType):
+    if not storageDType:
+        return numpy.dtype(numpyStreamDType)
+    elif "float16" != storageDType:
+        raise ValueError("Invalid storage type: {0}".format(storageDType))
+    elif "f" != numpyStreamDType.kind:
+        raise TypeError("Only floating-point values can be stored as {0}.".format(storageDType))
+
+    return HalfPrecisionDType
+
 def dtypeToComplex(dtype, errorIfAlreadyComplex=False):
     if dtype.isComplex():
         if errorIfAlreadyComplex:
@@ -56,7 +295,7 @@ def dtypeToComplex(dtype, errorIfAlreadyComplex=False):
         else:
             return dtype
 
-    return DType("complex_"+dtype.name())
+    return DType("complex_"+dtype.name(), dtype.dimension())
 
 def dtypeToScalar(dtype, errorIfAlreadyScalar=False):
     if not dtype.isComplex():
@@ -65,7 +304,7 @@ def dtypeToScalar(dtype, errorIfAlreadyScalar=False):
         else:
             return dtype
 
-    return DType(dtype.name().replace("complex_",""))
+    return DType(dtype.name().replace("complex_",""), dtype.dimension())
 
 def validateComplexParamRange(param, blockDType):
     VALUE_ERROR_TEMPLATE = "{0} part of given value {1} is outside the valid {2} range [{3}, {4}]."
@@ -143,3 +382,26 @@ def errorForUnevenIntegralSpace(func, start, stop, numValues, numpyDType):
 def errorForLeftGERight(left, right):
     if (type(left) in [int, float]) and (type(right) in [int, float]) and (left >= right):
         raise ValueError("{0} >= {1}".format(left, right))
+
+# Hint to the OS that the given element range of a memory-mapped array will
+# be read soon. For 2D arrays, the range is applied to each row. This is a
+# no-op for arrays that aren't memory-mapped or on platforms without madvise.
+def prefetchMemmapRegion(arr, start, stop):
+    mm = getattr(arr, "_mmap", None)
+    if (mm is None) or (not hasattr(mm, "madvise")) or (not hasattr(mmap, "MADV_WILLNEED")):
+        return
+    if stop <= start:
+        return
+
+    mmapAddress = numpy.frombuffer(mm, dtype=numpy.uint8).ctypes.data
+    rows = arr if (2 == len(arr.shape)) else [arr]
+
+    for row in rows:
+        if not row.flags.c_contiguous:
+            continue
+
+        begin = row.ctypes.data - mmapAddress + (start * row.itemsize)
+        end = min(len(mm), begin + ((stop - start) * row.itemsize))
+        alignedBegin = begin - (begin % mmap.PAGESIZE)
+        if end > alignedBegin:
+            mm.madvise(mmap.MADV_WILLNEED, alignedBegin, end - alignedBegin)
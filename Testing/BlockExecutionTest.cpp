@@ -11,6 +11,7 @@
 #include <Poco/Thread.h>
 
 #include <algorithm>
+#include <cmath>
 #include <complex>
 #include <cstdint>
 #include <string>
@@ -204,4 +205,121 @@ void testBlockExecutionCommon(
     }
 }
 
+template <typename T>
+static Pothos::BufferChunk getFastMathOutputs(
+    const std::string& blockRegistryPath,
+    const std::string& precision,
+    const std::vector<T>& inputs)
+{
+    static const Pothos::DType dtype(typeid(T));
+
+    auto testBlock = Pothos::BlockRegistry::make(
+                         blockRegistryPath,
+                         dtype);
+    testBlock.call("setPrecision", precision);
+    POTHOS_TEST_EQUAL(
+        precision,
+        testBlock.call<std::string>("precision"));
+
+    auto feederSource = Pothos::BlockRegistry::make(
+                            "/blocks/feeder_source",
+                            dtype);
+    feederSource.call(
+        "feedBuffer",
+        stdVectorToBufferChunk(inputs));
+
+    auto collectorSink = Pothos::BlockRegistry::make(
+                             "/blocks/collector_sink",
+                             dtype);
+
+    {
+        Pothos::Topology topology;
+        topology.connect(
+            feederSource, 0,
+            testBlock, 0);
+        topology.connect(
+            testBlock, 0,
+            collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
+    }
+
+    return collectorSink.call<Pothos::BufferChunk>("getBuffer");
+}
+
+// For complex values, the bounds apply to the magnitudes of the input,
+// output and error.
+template <typename T>
+static void testFastMathOutputs(
+    const std::string& blockRegistryPath,
+    const std::vector<T>& inputs,
+    double maxRelError,
+    double maxAbsError,
+    double maxArgError)
+{
+    const auto fullOutputs = getFastMathOutputs(blockRegistryPath, "FULL", inputs);
+    const auto fastOutputs = getFastMathOutputs(blockRegistryPath, "FAST", inputs);
+    POTHOS_TEST_EQUAL(inputs.size(), fullOutputs.elements());
+    POTHOS_TEST_EQUAL(inputs.size(), fastOutputs.elements());
+
+    const auto* fullBuf = fullOutputs.as<const T*>();
+    const auto* fastBuf = fastOutputs.as<const T*>();
+    for(size_t i = 0; i < inputs.size(); ++i)
+    {
+        const double maxError = (maxRelError * std::abs(fullBuf[i]))
+                              + maxAbsError
+                              + (maxArgError * std::abs(inputs[i]));
+        POTHOS_TEST_LE(std::abs(fastBuf[i] - fullBuf[i]), maxError);
+    }
+}
+
+void testFastMath(
+    const std::string& blockRegistryPath,
+    double low,
+    double high,
+    double maxRelError,
+    double maxAbsError,
+    double maxArgError,
+    bool supportsComplex)
+{
+    static constexpr size_t numInputs = 100000;
+
+    std::cout << blockRegistryPath << " (FAST precision)" << std::endl;
+
+    const auto inputs = linspace<double>(low, high, numInputs);
+    testFastMathOutputs(
+        blockRegistryPath,
+        inputs,
+        maxRelError,
+        maxAbsError,
+        maxArgError);
+
+    // Sweep the real and imaginary parts over the range in opposite
+    // directions.
+    if(supportsComplex)
+    {
+        std::vector<std::complex<double>> complexInputs;
+        for(size_t i = 0; i < numInputs; ++i)
+        {
+            complexInputs.emplace_back(inputs[i], inputs[numInputs - 1 - i]);
+        }
+
+        testFastMathOutputs(
+            blockRegistryPath,
+            complexInputs,
+            maxRelError,
+            maxAbsError,
+            maxArgError);
+    }
+
+    // Only blocks with known error bounds support FAST precision.
+    auto block = Pothos::BlockRegistry::make(
+                     blockRegistryPath,
+                     "float64");
+    POTHOS_TEST_THROWS(
+        block.call("setPrecision", "INVALID"),
+        Pothos::ProxyExceptionMessage);
+}
+
 }
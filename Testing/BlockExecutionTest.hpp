@@ -20,6 +20,18 @@ void testBlockExecutionCommon(
     const Pothos::Proxy& testBlock,
     bool longTimeout = false);
 
+// Compares a block's FAST precision output to its FULL precision output over
+// the given input range. The error may be at most
+// (maxRelError * |y|) + maxAbsError + (maxArgError * |x|).
+void testFastMath(
+    const std::string& blockRegistryPath,
+    double low,
+    double high,
+    double maxRelError,
+    double maxAbsError,
+    double maxArgError,
+    bool supportsComplex);
+
 //
 // Calls into manual tests
 //
@@ -0,0 +1,132 @@
+// Copyright (c) 2019-2020 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "TestUtility.hpp"
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+template <typename InType, typename OutType>
+static void testAsType(
+    const std::vector<InType>& inputs,
+    const std::string& overflow,
+    double scale,
+    const std::vector<OutType>& expectedOutputs)
+{
+    static const Pothos::DType inputDType(typeid(InType));
+    static const Pothos::DType outputDType(typeid(OutType));
+
+    std::cout << "Testing " << inputDType.toString() << " -> " << outputDType.toString()
+              << " (" << overflow << ", scale " << scale << ")..." << std::endl;
+
+    auto feederSource = Pothos::BlockRegistry::make(
+                            "/blocks/feeder_source",
+                            inputDType);
+    feederSource.call(
+        "feedBuffer",
+        NPTests::stdVectorToBufferChunk(inputs));
+
+    auto asType = Pothos::BlockRegistry::make(
+                      "/numpy/astype",
+                      inputDType,
+                      outputDType);
+    asType.call("setOverflow", overflow);
+    asType.call("setScale", scale);
+    POTHOS_TEST_EQUAL(
+        overflow,
+        asType.call<std::string>("overflow"));
+    POTHOS_TEST_EQUAL(
+        scale,
+        asType.call<double>("scale"));
+
+    auto collectorSink = Pothos::BlockRegistry::make(
+                             "/blocks/collector_sink",
+                             outputDType);
+
+    {
+        Pothos::Topology topology;
+        topology.connect(
+            feederSource, 0,
+            asType, 0);
+        topology.connect(
+            asType, 0,
+            collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
+    }
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedOutputs),
+        collectorSink.call<Pothos::BufferChunk>("getBuffer"));
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_astype)
+{
+    const std::vector<std::int16_t> int16Inputs = {-300, -129, -128, 0, 127, 128, 300};
+
+    testAsType<std::int16_t, std::int8_t>(
+        int16Inputs,
+        "WRAP",
+        1.0,
+        {-44, 127, -128, 0, 127, -128, 44});
+    testAsType<std::int16_t, std::int8_t>(
+        int16Inputs,
+        "SATURATE",
+        1.0,
+        {-128, -128, -128, 0, 127, 127, 127});
+    testAsType<std::int16_t, std::uint8_t>(
+        int16Inputs,
+        "SATURATE",
+        1.0,
+        {0, 0, 0, 0, 127, 128, 255});
+
+    // Scaled integers are computed as floats, which must still wrap.
+    testAsType<std::int16_t, std::int8_t>(
+        int16Inputs,
+        "WRAP",
+        2.0,
+        {-88, -2, 0, 0, -2, 0, 88});
+    testAsType<std::int16_t, std::int8_t>(
+        int16Inputs,
+        "SATURATE",
+        2.0,
+        {-128, -128, -128, 0, 127, 127, 127});
+
+    // Widening conversions don't saturate.
+    testAsType<std::int16_t, std::int32_t>(
+        int16Inputs,
+        "SATURATE",
+        1.0,
+        {-300, -129, -128, 0, 127, 128, 300});
+
+    // Normalized floats to integers, in one block
+    const std::vector<double> normalizedInputs =
+    {
+        -0.5, 0.0, 0.5, 1.0, 2.0,
+        std::numeric_limits<double>::quiet_NaN()
+    };
+    testAsType<double, std::uint8_t>(
+        normalizedInputs,
+        "SATURATE",
+        255.0,
+        {0, 0, 127, 255, 255, 0});
+    testAsType<double, std::int16_t>(
+        {-1.0, -0.5, 0.5, 1.0, 1.5},
+        "WRAP",
+        32768.0,
+        {-32768, -16384, 16384, -32768, -16384});
+
+    testAsType<double, float>(
+        {-1e300, -1.5, 1.5, 1e300},
+        "SATURATE",
+        1.0,
+        {std::numeric_limits<float>::lowest(), -1.5f, 1.5f, std::numeric_limits<float>::max()});
+}
@@ -0,0 +1,179 @@
+// Copyright (c) 2019-2020 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "TestUtility.hpp"
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+static constexpr size_t Decimation = 10;
+static constexpr size_t NumOutputs = 50;
+
+// Buffers that don't line up with frames, so partial frames must carry over
+static constexpr size_t BufferSize = 37;
+
+static std::vector<double> getInputs()
+{
+    // Plus a partial frame at the end, which has no output
+    std::vector<double> inputs;
+    for(size_t i = 0; i < ((NumOutputs * Decimation) + (Decimation / 2)); ++i)
+    {
+        inputs.emplace_back(std::sin(0.1 * i) * double(i % 13));
+    }
+
+    return inputs;
+}
+
+static double reduceFrame(
+    const std::string& reduction,
+    std::vector<double>::const_iterator begin,
+    std::vector<double>::const_iterator end)
+{
+    const double sum = std::accumulate(begin, end, 0.0);
+    const auto minMax = std::minmax_element(begin, end);
+
+    if("SUM" == reduction) return sum;
+    else if("MEAN" == reduction) return sum / Decimation;
+    else if("MAX" == reduction) return *minMax.second;
+    else if("MIN" == reduction) return *minMax.first;
+    else if("PTP" == reduction) return (*minMax.second - *minMax.first);
+
+    const double sumSquares = std::inner_product(begin, end, begin, 0.0);
+    return std::sqrt(sumSquares / Decimation);
+}
+
+template <typename InType, typename OutType>
+static void testBlockReduce(
+    const std::string& reduction,
+    const std::vector<InType>& inputs,
+    const std::vector<OutType>& expectedOutputs)
+{
+    static const Pothos::DType dtype(typeid(InType));
+    static const Pothos::DType outputDType(typeid(OutType));
+
+    std::cout << "Testing /numpy/block_reduce (" << dtype.name() << " -> "
+              << outputDType.name() << ", " << reduction << ")" << std::endl;
+
+    auto blockReduce = Pothos::BlockRegistry::make(
+                           "/numpy/block_reduce",
+                           dtype,
+                           reduction,
+                           Decimation);
+    POTHOS_TEST_EQUAL(reduction, blockReduce.call<std::string>("reduction"));
+    POTHOS_TEST_EQUAL(Decimation, blockReduce.call<size_t>("decimation"));
+
+    const auto collectors = NPTests::runBlock(
+                                blockReduce,
+                                {NPTests::feedInChunks(inputs, BufferSize)},
+                                {outputDType});
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedOutputs),
+        collectors[0].call("getBuffer"));
+}
+
+template <typename InType, typename OutType>
+static void testBlockReduce(const std::string& reduction)
+{
+    const auto doubleInputs = getInputs();
+
+    // Integer inputs cover the type's whole range, so sums and ranges
+    // overflow it.
+    std::vector<InType> inputs;
+    for(size_t i = 0; i < doubleInputs.size(); ++i)
+    {
+        inputs.emplace_back(std::is_integral<InType>::value ? InType((i * 37) % 256) : InType(doubleInputs[i]));
+    }
+    const std::vector<double> frameInputs(inputs.begin(), inputs.end());
+
+    std::vector<OutType> expectedOutputs;
+    for(size_t frame = 0; frame < NumOutputs; ++frame)
+    {
+        expectedOutputs.emplace_back(OutType(reduceFrame(
+            reduction,
+            frameInputs.begin() + (frame * Decimation),
+            frameInputs.begin() + ((frame + 1) * Decimation))));
+    }
+
+    testBlockReduce(reduction, inputs, expectedOutputs);
+}
+
+// The reductions complex values support
+static void testComplexBlockReduce()
+{
+    using Complex = std::complex<double>;
+
+    std::vector<Complex> inputs;
+    for(size_t i = 0; i < ((NumOutputs * Decimation) + (Decimation / 2)); ++i)
+    {
+        inputs.emplace_back(std::polar(double(i % 7), 0.1 * i));
+    }
+
+    std::vector<Complex> expectedSums;
+    std::vector<Complex> expectedMeans;
+    std::vector<double> expectedRMS;
+    for(size_t frame = 0; frame < NumOutputs; ++frame)
+    {
+        Complex sum;
+        double sumSquares = 0.0;
+        for(size_t i = (frame * Decimation); i < ((frame + 1) * Decimation); ++i)
+        {
+            sum += inputs[i];
+            sumSquares += std::norm(inputs[i]);
+        }
+
+        expectedSums.emplace_back(sum);
+        expectedMeans.emplace_back(sum / double(Decimation));
+        expectedRMS.emplace_back(std::sqrt(sumSquares / Decimation));
+    }
+
+    testBlockReduce("SUM", inputs, expectedSums);
+    testBlockReduce("MEAN", inputs, expectedMeans);
+    testBlockReduce("RMS", inputs, expectedRMS);
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_block_reduce)
+{
+    for(const std::string& reduction: {"SUM", "MEAN", "MAX", "MIN", "RMS", "PTP"})
+    {
+        testBlockReduce<double, double>(reduction);
+    }
+
+    // Integer sums are widened, means and RMS are floating-point, and the
+    // range of signed integers is unsigned.
+    testBlockReduce<std::int8_t, std::int64_t>("SUM");
+    testBlockReduce<std::uint8_t, std::uint64_t>("SUM");
+    testBlockReduce<std::int16_t, double>("MEAN");
+    testBlockReduce<std::int16_t, double>("RMS");
+    testBlockReduce<std::int8_t, std::int8_t>("MAX");
+    testBlockReduce<std::int8_t, std::uint8_t>("PTP");
+
+    testComplexBlockReduce();
+
+    // Complex values have no ordering.
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make(
+            "/numpy/block_reduce",
+            "complex_float64",
+            "MAX",
+            Decimation),
+        Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make(
+            "/numpy/block_reduce",
+            "float64",
+            "MEDIAN",
+            Decimation),
+        Pothos::ProxyExceptionMessage);
+}
@@ -0,0 +1,178 @@
+// Copyright (c) 2019-2020 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "TestUtility.hpp"
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using ComplexInt16 = std::complex<std::int16_t>;
+
+static const std::vector<ComplexInt16> Inputs0 =
+{
+    {1, -2}, {300, 400}, {-1000, 7}, {0, 0},
+    {32000, -32000}, {-5, 5}, {12, 34}, {-56, -78}
+};
+static const std::vector<ComplexInt16> Inputs1 =
+{
+    {3, 4}, {-300, 100}, {1000, 1000}, {2, -2},
+    {-32000, 32000}, {5, 5}, {1, 1}, {-1, 2}
+};
+
+// Every operation on complex integers saturates at the integer limits.
+static std::int16_t saturate(double value)
+{
+    return std::int16_t(std::max<double>(
+               std::numeric_limits<std::int16_t>::min(),
+               std::min<double>(std::numeric_limits<std::int16_t>::max(), value)));
+}
+
+static void testPairOperations()
+{
+    static const Pothos::DType dtype(typeid(ComplexInt16));
+
+    std::vector<ComplexInt16> expectedSums;
+    std::vector<ComplexInt16> expectedDiffs;
+    std::vector<ComplexInt16> expectedConjugates;
+    for(size_t i = 0; i < Inputs0.size(); ++i)
+    {
+        expectedSums.emplace_back(
+            saturate(double(Inputs0[i].real()) + Inputs1[i].real()),
+            saturate(double(Inputs0[i].imag()) + Inputs1[i].imag()));
+        expectedDiffs.emplace_back(
+            saturate(double(Inputs0[i].real()) - Inputs1[i].real()),
+            saturate(double(Inputs0[i].imag()) - Inputs1[i].imag()));
+        expectedConjugates.emplace_back(
+            Inputs0[i].real(),
+            saturate(-double(Inputs0[i].imag())));
+    }
+
+    std::cout << " * /numpy/add" << std::endl;
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedSums),
+        NPTests::runBlock(
+            Pothos::BlockRegistry::make("/numpy/add", dtype, 2),
+            {NPTests::feedInChunks(Inputs0), NPTests::feedInChunks(Inputs1)},
+            {dtype})[0].call("getBuffer"));
+
+    std::cout << " * /numpy/subtract" << std::endl;
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedDiffs),
+        NPTests::runBlock(
+            Pothos::BlockRegistry::make("/numpy/subtract", dtype),
+            {NPTests::feedInChunks(Inputs0), NPTests::feedInChunks(Inputs1)},
+            {dtype})[0].call("getBuffer"));
+
+    std::cout << " * /numpy/conjugate" << std::endl;
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedConjugates),
+        NPTests::runBlock(
+            Pothos::BlockRegistry::make("/numpy/conjugate", dtype),
+            {NPTests::feedInChunks(Inputs0)},
+            {dtype})[0].call("getBuffer"));
+}
+
+static void testMultiply()
+{
+    static const Pothos::DType dtype(typeid(ComplexInt16));
+
+    // Products are computed as complex floats, then rounded and saturated.
+    std::vector<ComplexInt16> expectedOutputs;
+    for(size_t i = 0; i < Inputs0.size(); ++i)
+    {
+        const auto product = std::complex<double>(Inputs0[i].real(), Inputs0[i].imag())
+                           * std::complex<double>(Inputs1[i].real(), Inputs1[i].imag());
+        expectedOutputs.emplace_back(saturate(product.real()), saturate(product.imag()));
+    }
+
+    std::cout << " * /numpy/multiply" << std::endl;
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedOutputs),
+        NPTests::runBlock(
+            Pothos::BlockRegistry::make("/numpy/multiply", dtype, 2),
+            {NPTests::feedInChunks(Inputs0), NPTests::feedInChunks(Inputs1)},
+            {dtype})[0].call("getBuffer"));
+}
+
+static void testMean()
+{
+    static const Pothos::DType dtype(typeid(ComplexInt16));
+
+    std::complex<double> expectedMean;
+    for(const auto& input: Inputs0)
+    {
+        expectedMean += std::complex<double>(input.real(), input.imag());
+    }
+    expectedMean /= double(Inputs0.size());
+
+    std::cout << " * /numpy/mean" << std::endl;
+
+    // The input buffer should be forwarded as-is.
+    const auto collector = NPTests::runBlock(
+                               Pothos::BlockRegistry::make("/numpy/mean", dtype, false),
+                               {NPTests::feedInChunks(Inputs0)},
+                               {dtype})[0];
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(Inputs0),
+        collector.call("getBuffer"));
+
+    const auto labels = collector.call<std::vector<Pothos::Label>>("getLabels");
+
+    POTHOS_TEST_EQUAL(1, labels.size());
+    POTHOS_TEST_EQUAL("MEAN", labels[0].id);
+
+    const auto mean = labels[0].data.convert<std::complex<double>>();
+    POTHOS_TEST_CLOSE(expectedMean.real(), mean.real(), 1e-3);
+    POTHOS_TEST_CLOSE(expectedMean.imag(), mean.imag(), 1e-3);
+}
+
+static void testFFT()
+{
+    static const Pothos::DType dtype(typeid(ComplexInt16));
+    static const Pothos::DType floatDType(typeid(std::complex<float>));
+
+    std::vector<std::complex<float>> floatInputs;
+    for(const auto& input: Inputs0)
+    {
+        floatInputs.emplace_back(input.real(), input.imag());
+    }
+
+    std::cout << " * /numpy/fft/fft" << std::endl;
+
+    // The FFT of complex_int16 input should match that of the equivalent
+    // complex_float32 input.
+    auto fft = Pothos::BlockRegistry::make("/numpy/fft/fft", dtype, Inputs0.size());
+    const auto collectors = NPTests::runBlock(
+                                fft,
+                                {NPTests::feedInChunks(Inputs0)},
+                                {floatDType});
+
+    auto floatFFT = Pothos::BlockRegistry::make("/numpy/fft/fft", floatDType, floatInputs.size());
+    const auto floatCollectors = NPTests::runBlock(
+                                     floatFFT,
+                                     {NPTests::feedInChunks(floatInputs)},
+                                     {floatDType});
+
+    NPTests::testBufferChunk(
+        floatCollectors[0].call<Pothos::BufferChunk>("getBuffer"),
+        collectors[0].call<Pothos::BufferChunk>("getBuffer"));
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_complex_int)
+{
+    std::cout << "Testing complex_int16..." << std::endl;
+
+    testPairOperations();
+    testMultiply();
+    testMean();
+    testFFT();
+}
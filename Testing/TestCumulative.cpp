@@ -0,0 +1,176 @@
+// Copyright (c) 2019-2020 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "TestUtility.hpp"
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static constexpr size_t NumElements = 1000;
+
+// Buffers that don't line up with anything, so the blocks' state must carry
+// over between them
+static constexpr size_t BufferSize = 97;
+
+template <typename T>
+static void testCumSum(const std::vector<T>& inputs)
+{
+    const std::string dtypeName = Pothos::DType(typeid(T)).name();
+    std::cout << "Testing /numpy/cumsum (" << dtypeName << ")" << std::endl;
+
+    // The block accumulates single-precision values in double precision.
+    std::vector<T> expectedOutputs;
+    double total = 0.0;
+    for(const T& input: inputs)
+    {
+        total += input;
+        expectedOutputs.emplace_back(T(total));
+    }
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedOutputs),
+        NPTests::runBlock(
+            Pothos::BlockRegistry::make("/numpy/cumsum", dtypeName),
+            {NPTests::feedInChunks(inputs, BufferSize)},
+            {Pothos::DType(dtypeName)})[0].call("getBuffer"));
+}
+
+static void testCompensatedCumSum()
+{
+    std::cout << "Testing /numpy/cumsum (compensation)" << std::endl;
+
+    // Adding 1.0 to 1e16 rounds back to 1e16, so a naive running sum loses
+    // every one of the first ones and ends up 999 short.
+    std::vector<double> inputs{1e16};
+    inputs.insert(inputs.end(), 999, 1.0);
+    inputs.emplace_back(-1e16);
+    inputs.insert(inputs.end(), 1000, 1.0);
+
+    // Every prefix sum is an integer, so it's exact as an int64_t.
+    std::vector<double> expectedOutputs;
+    std::int64_t total = 0;
+    for(double input: inputs)
+    {
+        total += std::int64_t(input);
+        expectedOutputs.emplace_back(double(total));
+    }
+    POTHOS_TEST_EQUAL(1999.0, expectedOutputs.back());
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedOutputs),
+        NPTests::runBlock(
+            Pothos::BlockRegistry::make("/numpy/cumsum", "float64"),
+            {NPTests::feedInChunks(inputs, BufferSize)},
+            {Pothos::DType("float64")})[0].call("getBuffer"));
+}
+
+static void testCumProd()
+{
+    std::cout << "Testing /numpy/cumprod" << std::endl;
+
+    // Values near 1, so the product stays within range
+    const auto inputs = NPTests::linspace<double>(0.999, 1.001, NumElements);
+
+    std::vector<double> expectedOutputs;
+    double product = 1.0;
+    for(double input: inputs)
+    {
+        product *= input;
+        expectedOutputs.emplace_back(product);
+    }
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedOutputs),
+        NPTests::runBlock(
+            Pothos::BlockRegistry::make("/numpy/cumprod", "float64"),
+            {NPTests::feedInChunks(inputs, BufferSize)},
+            {Pothos::DType("float64")})[0].call("getBuffer"));
+}
+
+static void testDiff()
+{
+    std::cout << "Testing /numpy/diff" << std::endl;
+
+    std::vector<int> inputs;
+    for(size_t i = 0; i < NumElements; ++i)
+    {
+        inputs.emplace_back(int(i * i) - 500);
+    }
+
+    // The first value has no previous value.
+    std::vector<int> expectedOutputs;
+    for(size_t i = 1; i < inputs.size(); ++i)
+    {
+        expectedOutputs.emplace_back(inputs[i] - inputs[i-1]);
+    }
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedOutputs),
+        NPTests::runBlock(
+            Pothos::BlockRegistry::make("/numpy/diff", "int32"),
+            {NPTests::feedInChunks(inputs, BufferSize)},
+            {Pothos::DType("int32")})[0].call("getBuffer"));
+}
+
+static void testGradient()
+{
+    std::cout << "Testing /numpy/gradient" << std::endl;
+
+    static constexpr double spacing = 0.5;
+
+    std::vector<double> inputs;
+    for(double x: NPTests::linspace<double>(-2.0, 2.0, NumElements))
+    {
+        inputs.emplace_back(x * x * x);
+    }
+
+    // One-sided for the first value, central for the rest, and none for the
+    // last, which has no next value
+    std::vector<double> expectedOutputs;
+    expectedOutputs.emplace_back((inputs[1] - inputs[0]) / spacing);
+    for(size_t i = 1; i < (inputs.size() - 1); ++i)
+    {
+        expectedOutputs.emplace_back((inputs[i+1] - inputs[i-1]) / (2.0 * spacing));
+    }
+
+    auto gradient = Pothos::BlockRegistry::make(
+                        "/numpy/gradient",
+                        "float64",
+                        spacing);
+    POTHOS_TEST_EQUAL(spacing, gradient.call<double>("spacing"));
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedOutputs),
+        NPTests::runBlock(
+            gradient,
+            {NPTests::feedInChunks(inputs, BufferSize)},
+            {Pothos::DType("float64")})[0].call("getBuffer"));
+
+    POTHOS_TEST_THROWS(
+        gradient.call("setSpacing", 0.0),
+        Pothos::ProxyExceptionMessage);
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_cumulative)
+{
+    testCumSum(NPTests::linspace<double>(-10.0, 10.0, NumElements));
+    testCumSum(NPTests::linspace<float>(-10.0f, 10.0f, NumElements));
+
+    std::vector<int> intInputs;
+    for(size_t i = 0; i < NumElements; ++i)
+    {
+        intInputs.emplace_back(int(i % 17) - 8);
+    }
+    testCumSum(intInputs);
+    testCompensatedCumSum();
+
+    testCumProd();
+    testDiff();
+    testGradient();
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2019-2020 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "TestUtility.hpp"
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Fed as a single buffer, so with more than one thread, the block is given
+// several tiles' worth at once.
+static constexpr size_t NumElements = 50000;
+
+static Pothos::BufferChunk runExpression(
+    const std::string& expression,
+    const std::vector<std::vector<double>>& inputs,
+    size_t numThreads)
+{
+    static const Pothos::DType dtype("float64");
+
+    std::cout << "Testing \"" << expression << "\" (" << numThreads << " threads)..." << std::endl;
+
+    auto expressionBlock = Pothos::BlockRegistry::make(
+                               "/numpy/expression",
+                               dtype,
+                               inputs.size(),
+                               expression);
+    expressionBlock.call("setNumThreads", numThreads);
+    POTHOS_TEST_EQUAL(
+        expression,
+        expressionBlock.call<std::string>("expression"));
+    POTHOS_TEST_EQUAL(
+        numThreads,
+        expressionBlock.call<size_t>("numThreads"));
+
+    std::vector<Pothos::Proxy> feeders;
+    for(const auto& chanInputs: inputs)
+    {
+        feeders.emplace_back(NPTests::feedInChunks(chanInputs));
+    }
+
+    return NPTests::runBlock(
+               expressionBlock,
+               feeders,
+               {dtype})[0].call<Pothos::BufferChunk>("getBuffer");
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_expression)
+{
+    const auto inputs0 = NPTests::linspace<double>(-10, 10, NumElements);
+    const auto inputs1 = NPTests::linspace<double>(0.5, 5, NumElements);
+
+    std::vector<double> expectedPowers;
+    std::vector<double> expectedCombined;
+    for(size_t i = 0; i < NumElements; ++i)
+    {
+        const auto x = inputs0[i];
+        expectedPowers.emplace_back(10.0 * std::log10((x*x) + std::numeric_limits<double>::epsilon()));
+        expectedCombined.emplace_back((x * inputs1[i]) - std::sin(inputs1[i]) + 3.0);
+    }
+
+    for(size_t numThreads: {1, 4})
+    {
+        NPTests::testBufferChunk(
+            NPTests::stdVectorToBufferChunk(expectedPowers),
+            runExpression("10*log10(abs(x)**2 + eps)", {inputs0}, numThreads));
+        NPTests::testBufferChunk(
+            NPTests::stdVectorToBufferChunk(expectedCombined),
+            runExpression("x0*x1 - sin(x1) + 3", {inputs0, inputs1}, numThreads));
+    }
+
+    // Anything other than arithmetic on the inputs, constants, and known
+    // functions should be rejected.
+    for(const std::string& invalidExpression:
+        {"x +", "y", "x.real", "x[0]", "open(x)", "__import__('os')", "sin(x, out=x)"})
+    {
+        POTHOS_TEST_THROWS(
+            Pothos::BlockRegistry::make(
+                "/numpy/expression",
+                "float64",
+                1,
+                invalidExpression),
+            Pothos::ProxyExceptionMessage);
+    }
+}
@@ -10,9 +10,12 @@
 
 #include <Poco/Thread.h>
 
+#include <cmath>
 #include <complex>
 #include <iostream>
+#include <limits>
 #include <string>
+#include <vector>
 
 //
 // Parameters
@@ -480,6 +483,47 @@ static void testRFFT()
         NPTests::stdVectorToBufferChunk(testParams.inputs));
 }
 
+// Real input to /numpy/fft/fft goes through a real-to-complex transform, so
+// the full spectrum is the RFFT's output and its conjugate mirror image.
+template <typename T>
+static void testRealInputFFT(bool oneSided)
+{
+    const std::string blockRegistryPath = "/numpy/fft/fft";
+
+    using Complex = std::complex<T>;
+
+    const auto testParams = getRFFTTestParams<T, Complex>();
+    const size_t numBins = testParams.inputs.size();
+
+    auto expectedOutputs = testParams.outputs;
+    if(!oneSided)
+    {
+        for(size_t bin = expectedOutputs.size(); bin < numBins; ++bin)
+        {
+            expectedOutputs.emplace_back(std::conj(testParams.outputs[numBins - bin]));
+        }
+    }
+
+    Pothos::DType dtype(typeid(T));
+    Pothos::DType complexDType(typeid(Complex));
+    std::cout << "Testing " << blockRegistryPath << " with " << dtype.toString()
+              << " input (one-sided: " << (oneSided ? "true" : "false") << ")" << std::endl;
+
+    Pothos::Proxy fftBlock = Pothos::BlockRegistry::make(
+                                 blockRegistryPath,
+                                 dtype,
+                                 numBins,
+                                 oneSided);
+    testOutputPortType<Complex>(fftBlock);
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedOutputs),
+        NPTests::runBlock(
+            fftBlock,
+            {NPTests::feedInChunks(testParams.inputs)},
+            {complexDType})[0].call("getBuffer"));
+}
+
 template <typename T>
 static void testHFFT()
 {
@@ -548,6 +592,255 @@ static void testHFFT()
         NPTests::stdVectorToBufferChunk(testParams.revOutputs));
 }
 
+static void testPowerSpectrum(const std::string& averaging, bool decibels)
+{
+    static const Pothos::DType dtype("complex_float64");
+    static constexpr size_t numBins = 16;
+    static constexpr size_t numAverages = 4;
+    static constexpr size_t numOutputFrames = 3;
+
+    std::cout << "Testing /numpy/fft/power_spectrum (" << averaging
+              << ", decibels: " << (decibels ? "true" : "false") << ")" << std::endl;
+
+    // A frame with a constant value has all of its power at DC, so with a
+    // rectangular window, each frame's spectrum is A^2 in the first bin. The
+    // amplitude changes every frame, so the averaging modes give different
+    // results.
+    static constexpr size_t numFrames = numAverages * numOutputFrames;
+    std::vector<std::complex<double>> inputs;
+    std::vector<double> powers;
+    for(size_t frame = 0; frame < numFrames; ++frame)
+    {
+        const double amplitude = 1.0 + (0.5 * frame);
+        inputs.insert(inputs.end(), numBins, std::complex<double>(amplitude, 0.0));
+        powers.emplace_back(amplitude * amplitude);
+    }
+
+    // A partial frame, which isn't output
+    inputs.insert(inputs.end(), (numBins / 2), std::complex<double>(1.0, 0.0));
+
+    // Linear averages are over each output's own frames. Exponential averages
+    // carry over, with a time constant of numAverages frames.
+    std::vector<double> expectedPowers;
+    double average = 0.0;
+    for(size_t frame = 0; frame < numFrames; ++frame)
+    {
+        if("LINEAR" == averaging)
+        {
+            average += (powers[frame] / numAverages);
+        }
+        else
+        {
+            average = (0 == frame) ? powers[frame] : (average + ((powers[frame] - average) / numAverages));
+        }
+
+        if(0 == ((frame + 1) % numAverages))
+        {
+            expectedPowers.emplace_back(average);
+            if("LINEAR" == averaging) average = 0.0;
+        }
+    }
+
+    std::vector<double> expectedOutputs;
+    for(double power: expectedPowers)
+    {
+        expectedOutputs.emplace_back(decibels ? (10.0 * std::log10(power)) : power);
+        for(size_t bin = 1; bin < numBins; ++bin)
+        {
+            expectedOutputs.emplace_back(decibels ? (10.0 * std::log10(std::numeric_limits<double>::min())) : 0.0);
+        }
+    }
+
+    auto powerSpectrum = Pothos::BlockRegistry::make(
+                             "/numpy/fft/power_spectrum",
+                             dtype,
+                             numBins,
+                             "RECTANGULAR",
+                             numAverages,
+                             averaging,
+                             decibels);
+    POTHOS_TEST_EQUAL(numAverages, powerSpectrum.call<size_t>("numAverages"));
+    POTHOS_TEST_EQUAL(averaging, powerSpectrum.call<std::string>("averaging"));
+    POTHOS_TEST_EQUAL(decibels, powerSpectrum.call<bool>("decibels"));
+    testOutputPortType<double>(powerSpectrum);
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedOutputs),
+        NPTests::runBlock(
+            powerSpectrum,
+            {NPTests::feedInChunks(inputs)},
+            {Pothos::DType("float64")})[0].call("getBuffer"));
+
+    POTHOS_TEST_THROWS(
+        powerSpectrum.call("setNumAverages", 0),
+        Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_THROWS(
+        powerSpectrum.call("setAveraging", "MEDIAN"),
+        Pothos::ProxyExceptionMessage);
+}
+
+static const double Pi = std::acos(-1.0);
+
+// The segmented FFT blocks output one vector element per frame, so compare
+// their outputs as scalars.
+static Pothos::BufferChunk getScalarBuffer(const Pothos::Proxy& collector)
+{
+    auto buffer = collector.call<Pothos::BufferChunk>("getBuffer");
+    buffer.dtype = Pothos::DType(buffer.dtype.name());
+
+    return buffer;
+}
+
+static void testSTFT()
+{
+    static const Pothos::DType dtype("complex_float64");
+    static constexpr size_t numBins = 16;
+    static constexpr size_t overlap = 8;
+    static constexpr size_t step = numBins - overlap;
+    static constexpr size_t numOutputFrames = 5;
+
+    std::cout << "Testing /numpy/fft/stft" << std::endl;
+
+    // A tone at the center of bin 3, whose phase at the start of each segment
+    // alternates between 0 and pi.
+    static constexpr size_t toneBin = 3;
+    static constexpr double amplitude = 1.5;
+    std::vector<std::complex<double>> inputs;
+    for(size_t i = 0; i < (numBins + (step * (numOutputFrames - 1)) + (step / 2)); ++i)
+    {
+        inputs.emplace_back(std::polar(amplitude, 2.0 * Pi * toneBin * i / numBins));
+    }
+
+    std::vector<std::complex<double>> expectedOutputs;
+    for(size_t frame = 0; frame < numOutputFrames; ++frame)
+    {
+        for(size_t bin = 0; bin < numBins; ++bin)
+        {
+            const double value = (toneBin == bin) ? ((frame % 2) ? -amplitude : amplitude) : 0.0;
+            expectedOutputs.emplace_back(value, 0.0);
+        }
+    }
+
+    auto stft = Pothos::BlockRegistry::make(
+                    "/numpy/fft/stft",
+                    dtype,
+                    numBins,
+                    "RECTANGULAR",
+                    overlap);
+    POTHOS_TEST_EQUAL(overlap, stft.call<size_t>("overlap"));
+    testOutputPortType<std::complex<double>>(stft);
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedOutputs),
+        getScalarBuffer(NPTests::runBlock(
+            stft,
+            {NPTests::feedInChunks(inputs)},
+            {Pothos::DType(dtype.name(), numBins)})[0]));
+
+    POTHOS_TEST_THROWS(
+        stft.call("setOverlap", numBins),
+        Pothos::ProxyExceptionMessage);
+}
+
+static void testWelch()
+{
+    static const Pothos::DType dtype("float64");
+    static constexpr size_t numBins = 16;
+    static constexpr size_t numOutputBins = (numBins / 2) + 1;
+    static constexpr size_t overlap = 8;
+    static constexpr size_t step = numBins - overlap;
+    static constexpr size_t numSegments = 3;
+    static constexpr size_t numOutputFrames = 2;
+
+    std::cout << "Testing /numpy/fft/welch" << std::endl;
+
+    // A real tone at the center of bin 4. With SPECTRUM scaling, its power
+    // (A^2/2) is all in that bin, as the negative frequency's power is added
+    // to the positive one.
+    static constexpr size_t toneBin = 4;
+    static constexpr double amplitude = 2.0;
+    std::vector<double> inputs;
+    for(size_t i = 0; i < (numBins + (step * ((numSegments * numOutputFrames) - 1)) + (step / 2)); ++i)
+    {
+        inputs.emplace_back(amplitude * std::cos(2.0 * Pi * toneBin * i / numBins));
+    }
+
+    std::vector<double> expectedOutputs;
+    for(size_t frame = 0; frame < numOutputFrames; ++frame)
+    {
+        for(size_t bin = 0; bin < numOutputBins; ++bin)
+        {
+            expectedOutputs.emplace_back((toneBin == bin) ? (amplitude * amplitude / 2.0) : 0.0);
+        }
+    }
+
+    auto welch = Pothos::BlockRegistry::make(
+                     "/numpy/fft/welch",
+                     dtype,
+                     numBins,
+                     "RECTANGULAR",
+                     overlap,
+                     numSegments,
+                     1.0,
+                     "SPECTRUM");
+    POTHOS_TEST_EQUAL(numSegments, welch.call<size_t>("numSegments"));
+    POTHOS_TEST_EQUAL("SPECTRUM", welch.call<std::string>("scaling"));
+    testOutputPortType<double>(welch);
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedOutputs),
+        getScalarBuffer(NPTests::runBlock(
+            welch,
+            {NPTests::feedInChunks(inputs)},
+            {Pothos::DType(dtype.name(), numOutputBins)})[0]));
+
+    POTHOS_TEST_THROWS(
+        welch.call("setNumSegments", 0),
+        Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_THROWS(
+        welch.call("setScaling", "POWER"),
+        Pothos::ProxyExceptionMessage);
+}
+
+static void testLargeFFT(size_t numThreads)
+{
+    static const Pothos::DType dtype("complex_float64");
+
+    // Large enough for the four-step algorithm
+    static constexpr size_t numBins = (1 << 18);
+
+    std::cout << "Testing /numpy/fft/fft with " << numBins << " bins and "
+              << numThreads << " thread(s)" << std::endl;
+
+    // The transform of an impulse at n0 is exp(-2*pi*j*k*n0/N).
+    static constexpr size_t impulseIndex = 5;
+    std::vector<std::complex<double>> inputs(numBins);
+    inputs[impulseIndex] = 1.0;
+
+    std::vector<std::complex<double>> expectedOutputs;
+    for(size_t bin = 0; bin < numBins; ++bin)
+    {
+        const size_t phaseIndex = (bin * impulseIndex) % numBins;
+        expectedOutputs.emplace_back(std::polar(1.0, -2.0 * Pi * phaseIndex / numBins));
+    }
+
+    auto fft = Pothos::BlockRegistry::make(
+                   "/numpy/fft/fft",
+                   dtype,
+                   numBins);
+    fft.call("setNumThreads", numThreads);
+    POTHOS_TEST_EQUAL(
+        (numThreads > 1),
+        fft.call<bool>("usesFourStep"));
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedOutputs),
+        NPTests::runBlock(
+            fft,
+            {NPTests::feedInChunks(inputs)},
+            {dtype})[0].call("getBuffer"));
+}
+
 // TODO: test scalar into FFT
 POTHOS_TEST_BLOCK("/numpy/tests", test_fft)
 {
@@ -558,7 +851,38 @@ POTHOS_TEST_BLOCK("/numpy/tests", test_fft)
     testRFFT<float>();
     testRFFT<double>();
 
+    for(bool oneSided: {false, true})
+    {
+        testRealInputFFT<float>(oneSided);
+        testRealInputFFT<double>(oneSided);
+    }
+
     // TODO: test complex input
     testHFFT<float>();
     testHFFT<double>();
 }
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_power_spectrum)
+{
+    for(const std::string& averaging: {"LINEAR", "EXPONENTIAL"})
+    {
+        testPowerSpectrum(averaging, false);
+        testPowerSpectrum(averaging, true);
+    }
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_stft)
+{
+    testSTFT();
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_welch)
+{
+    testWelch();
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_large_fft)
+{
+    testLargeFFT(1);
+    testLargeFFT(4);
+}
@@ -0,0 +1,262 @@
+// Copyright (c) 2019-2020 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "TestUtility.hpp"
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+static const double Pi = std::acos(-1.0);
+
+// Inputs are fed in two buffers, split at an index that isn't a multiple of
+// any rate used in these tests, so state must carry over.
+template <typename T>
+static size_t getSplitIndex(const std::vector<T>& values)
+{
+    return (values.size() / 2) + 3;
+}
+
+//
+// /numpy/channelizer
+//
+
+static void testChannelizer(const std::string& outputMode)
+{
+    static const Pothos::DType dtype("complex_float64");
+    static constexpr size_t numChannels = 8;
+    static constexpr size_t toneChannel = 3;
+    static constexpr size_t numFrames = 20;
+
+    std::cout << "Testing /numpy/channelizer (" << outputMode << ")" << std::endl;
+
+    // A moving average over two frames, whose response is zero at every
+    // channel center but the first, so the tone shows up in one channel.
+    const std::vector<double> taps(2 * numChannels, 1.0 / (2 * numChannels));
+
+    std::vector<std::complex<double>> inputs;
+    for(size_t i = 0; i < ((numFrames + 1) * numChannels); ++i)
+    {
+        inputs.emplace_back(std::polar(1.0, 2.0 * Pi * toneChannel * i / numChannels));
+    }
+
+    auto channelizer = Pothos::BlockRegistry::make(
+                           "/numpy/channelizer",
+                           dtype,
+                           numChannels,
+                           taps,
+                           outputMode);
+    POTHOS_TEST_EQUAL(numChannels, channelizer.call<size_t>("numChannels"));
+    POTHOS_TEST_EQUAL(outputMode, channelizer.call<std::string>("outputMode"));
+
+    const bool isVector = ("VECTOR" == outputMode);
+    const size_t numPorts = isVector ? 1 : numChannels;
+
+    const auto collectors = NPTests::runBlock(
+                                channelizer,
+                                {NPTests::feedInChunks(inputs, getSplitIndex(inputs))},
+                                std::vector<Pothos::DType>(
+                                    numPorts,
+                                    isVector ? Pothos::DType(dtype.name(), numChannels) : dtype));
+
+    if(isVector)
+    {
+        std::vector<std::complex<double>> expectedOutputs;
+        for(size_t frame = 0; frame < numFrames; ++frame)
+        {
+            for(size_t chan = 0; chan < numChannels; ++chan)
+            {
+                expectedOutputs.emplace_back((toneChannel == chan) ? 1.0 : 0.0);
+            }
+        }
+
+        auto outputs = collectors[0].call<Pothos::BufferChunk>("getBuffer");
+        outputs.dtype = dtype;
+        NPTests::testBufferChunk(
+            NPTests::stdVectorToBufferChunk(expectedOutputs),
+            outputs);
+    }
+    else
+    {
+        for(size_t chan = 0; chan < numChannels; ++chan)
+        {
+            const std::vector<std::complex<double>> expectedOutputs(
+                numFrames,
+                (toneChannel == chan) ? 1.0 : 0.0);
+
+            NPTests::testBufferChunk(
+                NPTests::stdVectorToBufferChunk(expectedOutputs),
+                collectors[chan].call("getBuffer"));
+        }
+    }
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_channelizer)
+{
+    testChannelizer("VECTOR");
+    testChannelizer("PORTS");
+
+    // An empty list of taps gives the default prototype filter.
+    auto channelizer = Pothos::BlockRegistry::make(
+                           "/numpy/channelizer",
+                           "complex_float32",
+                           16,
+                           std::vector<double>(),
+                           "VECTOR");
+    POTHOS_TEST_EQUAL(
+        (16U * 8U),
+        channelizer.call<std::vector<double>>("taps").size());
+
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make(
+            "/numpy/channelizer",
+            "complex_float32",
+            16,
+            std::vector<double>(),
+            "MATRIX"),
+        Pothos::ProxyExceptionMessage);
+}
+
+//
+// /numpy/fir_filter
+//
+
+template <typename T>
+static NPTests::EnableIfNotComplex<T, T> toOutput(const std::complex<double>& value)
+{
+    return T(value.real());
+}
+
+template <typename T>
+static NPTests::EnableIfComplex<T, T> toOutput(const std::complex<double>& value)
+{
+    return T(value);
+}
+
+// Zero-stuffs, filters, and decimates the given values the slow way.
+template <typename T, typename TapType>
+static std::vector<T> getExpectedFIROutputs(
+    const std::vector<T>& inputs,
+    const std::vector<TapType>& taps,
+    size_t interpolation,
+    size_t decimation)
+{
+    using Complex = std::complex<double>;
+
+    std::vector<Complex> upsampled(inputs.size() * interpolation, 0.0);
+    for(size_t i = 0; i < inputs.size(); ++i)
+    {
+        upsampled[i * interpolation] = Complex(inputs[i]);
+    }
+
+    std::vector<T> outputs;
+    for(size_t n = 0; n < upsampled.size(); n += decimation)
+    {
+        Complex output = 0.0;
+        for(size_t k = 0; (k < taps.size()) && (k <= n); ++k)
+        {
+            output += Complex(taps[k]) * upsampled[n - k];
+        }
+        outputs.emplace_back(toOutput<T>(output));
+    }
+
+    return outputs;
+}
+
+template <typename T, typename TapType>
+static void testFIRFilter(
+    const std::vector<T>& inputs,
+    const std::vector<TapType>& taps,
+    size_t interpolation,
+    size_t decimation)
+{
+    static const Pothos::DType dtype(typeid(T));
+
+    std::cout << "Testing /numpy/fir_filter (" << dtype.name()
+              << ", interpolation: " << interpolation
+              << ", decimation: " << decimation << ")" << std::endl;
+
+    const auto expectedOutputs = getExpectedFIROutputs(inputs, taps, interpolation, decimation);
+
+    Pothos::Proxy firFilter = Pothos::BlockRegistry::make(
+                                  "/numpy/fir_filter",
+                                  dtype,
+                                  taps,
+                                  interpolation,
+                                  decimation);
+    POTHOS_TEST_EQUAL(interpolation, firFilter.call<size_t>("interpolation"));
+    POTHOS_TEST_EQUAL(decimation, firFilter.call<size_t>("decimation"));
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedOutputs),
+        NPTests::runBlock(
+            firFilter,
+            {NPTests::feedInChunks(inputs, getSplitIndex(inputs))},
+            {dtype})[0].call("getBuffer"));
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_fir_filter)
+{
+    using ComplexFloat = std::complex<float>;
+    using ComplexDouble = std::complex<double>;
+
+    const std::vector<double> taps = {0.5, -1.0, 2.0, 0.25, 1.5, -0.75, 1.0};
+    const std::vector<ComplexDouble> complexTaps = {{0.5, 1.0}, {-1.0, 0.0}, {2.0, -0.5}, {0.25, 0.25}, {1.5, 0.0}};
+
+    const auto inputs = NPTests::linspace<double>(-10.0, 10.0, 101);
+    std::vector<ComplexFloat> complexFloatInputs;
+    std::vector<ComplexDouble> complexDoubleInputs;
+    for(double input: inputs)
+    {
+        complexFloatInputs.emplace_back(float(input), float(1.0 - (0.5 * input)));
+        complexDoubleInputs.emplace_back(input, 1.0 - (0.5 * input));
+    }
+
+    testFIRFilter(inputs, taps, 1, 1);
+    testFIRFilter(inputs, taps, 1, 3);
+    testFIRFilter(inputs, taps, 2, 1);
+    testFIRFilter(inputs, taps, 3, 2);
+
+    for(const auto& rates: std::vector<std::pair<size_t, size_t>>{{1, 1}, {1, 3}, {3, 2}})
+    {
+        testFIRFilter(complexDoubleInputs, taps, rates.first, rates.second);
+        testFIRFilter(complexDoubleInputs, complexTaps, rates.first, rates.second);
+        testFIRFilter(complexFloatInputs, taps, rates.first, rates.second);
+        testFIRFilter(complexFloatInputs, complexTaps, rates.first, rates.second);
+    }
+
+    // Complex taps need complex data.
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make(
+            "/numpy/fir_filter",
+            "float64",
+            complexTaps,
+            1,
+            1),
+        Pothos::ProxyExceptionMessage);
+
+    // Rates must be at least 1.
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make(
+            "/numpy/fir_filter",
+            "float64",
+            std::vector<double>(),
+            0,
+            1),
+        Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make(
+            "/numpy/fir_filter",
+            "float64",
+            std::vector<double>(),
+            1,
+            0),
+        Pothos::ProxyExceptionMessage);
+}
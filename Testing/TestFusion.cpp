@@ -0,0 +1,194 @@
+// Copyright (c) 2019-2020 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "TestUtility.hpp"
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Fed as a single buffer, so a fused block with more than one thread is
+// given several tiles' worth at once
+static constexpr size_t NumElements = 50000;
+
+//
+// negative -> exp -> rint, which are all element-wise and should be fused
+// into one block
+//
+static Pothos::BufferChunk runChain(
+    const std::vector<double>& inputs,
+    bool fuse)
+{
+    static const std::string dtype = "float64";
+
+    std::cout << "Testing chain (fuse: " << (fuse ? "true" : "false") << ")..." << std::endl;
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto numpyModule = env->findProxy("PothosNumPy");
+    auto blockEntryPoints = env->findProxy("PothosNumPy.BlockEntryPoints");
+
+    auto negativeBlock = blockEntryPoints.call("Negative", dtype);
+    auto expBlock = blockEntryPoints.call("Exp", dtype);
+    auto rintBlock = blockEntryPoints.call("RInt", dtype);
+
+    auto feederSource = NPTests::feedInChunks(inputs);
+    auto collectorSink = Pothos::BlockRegistry::make(
+                             "/blocks/collector_sink",
+                             dtype);
+
+    {
+        auto topology = numpyModule.call("FusingTopology", fuse);
+        topology.call("connect", feederSource, 0, negativeBlock, 0);
+        topology.call("connect", negativeBlock, 0, expBlock, 0);
+        topology.call("connect", expBlock, 0, rintBlock, 0);
+        topology.call("connect", rintBlock, 0, collectorSink, 0);
+
+        topology.call("commit");
+        POTHOS_TEST_TRUE(topology.call<bool>("waitInactive", 0.01));
+
+        auto fusedBlocks = topology.call("fusedBlocks");
+        POTHOS_TEST_EQUAL(
+            (fuse ? 1U : 0U),
+            fusedBlocks.call<size_t>("__len__"));
+        if(fuse)
+        {
+            POTHOS_TEST_EQUAL(
+                "/numpy/negative -> /numpy/exp -> /numpy/rint",
+                fusedBlocks.call("__getitem__", 0).call<std::string>("getName"));
+        }
+    }
+
+    return collectorSink.call<Pothos::BufferChunk>("getBuffer");
+}
+
+//
+// Fusion is opt-in, so a plain topology, like one loaded from a .pothos file
+// or built in the GUI, runs the same chain unfused. A fused block can still
+// be made by hand and connected to it.
+//
+static Pothos::BufferChunk runChainInPlainTopology(
+    const std::vector<double>& inputs,
+    bool fuse)
+{
+    static const std::string dtype = "float64";
+
+    std::cout << "Testing chain in plain topology (fuse: " << (fuse ? "true" : "false") << ")..." << std::endl;
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto fusionModule = env->findProxy("PothosNumPy.Fusion");
+
+    auto negativeBlock = Pothos::BlockRegistry::make("/numpy/negative", dtype);
+    auto expBlock = Pothos::BlockRegistry::make("/numpy/exp", dtype);
+    auto rintBlock = Pothos::BlockRegistry::make("/numpy/rint", dtype);
+
+    if(fuse)
+    {
+        auto fusedBlock = fusionModule.call(
+                              "FusedChainBlock",
+                              Pothos::ProxyVector{negativeBlock, expBlock, rintBlock});
+
+        return NPTests::runBlock(
+                   fusedBlock,
+                   {NPTests::feedInChunks(inputs)},
+                   {Pothos::DType(dtype)})[0].call<Pothos::BufferChunk>("getBuffer");
+    }
+
+    auto feederSource = NPTests::feedInChunks(inputs);
+    auto collectorSink = Pothos::BlockRegistry::make(
+                             "/blocks/collector_sink",
+                             dtype);
+
+    {
+        Pothos::Topology topology;
+        topology.connect(feederSource, 0, negativeBlock, 0);
+        topology.connect(negativeBlock, 0, expBlock, 0);
+        topology.connect(expBlock, 0, rintBlock, 0);
+        topology.connect(rintBlock, 0, collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
+    }
+
+    return collectorSink.call<Pothos::BufferChunk>("getBuffer");
+}
+
+//
+// The original blocks keep their parameters, so probes and setters called on
+// them after fusing apply to the fused block.
+//
+static void testFusedSetters(const std::vector<double>& inputs)
+{
+    static const std::string dtype = "float64";
+
+    std::cout << "Testing setters on a fused chain..." << std::endl;
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto fusionModule = env->findProxy("PothosNumPy.Fusion");
+
+    auto negativeBlock = Pothos::BlockRegistry::make("/numpy/negative", dtype);
+    auto sinBlock = Pothos::BlockRegistry::make("/numpy/sin", dtype);
+    auto fusedBlock = fusionModule.call(
+                          "FusedChainBlock",
+                          Pothos::ProxyVector{negativeBlock, sinBlock});
+    auto fusedSinBlock = fusedBlock.call("blocks").call("__getitem__", 1);
+
+    POTHOS_TEST_EQUAL("FULL", fusedSinBlock.call<std::string>("precision"));
+    const auto fullOutputs = NPTests::runBlock(
+                                 fusedBlock,
+                                 {NPTests::feedInChunks(inputs)},
+                                 {Pothos::DType(dtype)})[0].call<Pothos::BufferChunk>("getBuffer");
+
+    sinBlock.call("setPrecision", "FAST");
+    POTHOS_TEST_EQUAL("FAST", fusedSinBlock.call<std::string>("precision"));
+    const auto fastOutputs = NPTests::runBlock(
+                                 fusedBlock,
+                                 {NPTests::feedInChunks(inputs)},
+                                 {Pothos::DType(dtype)})[0].call<Pothos::BufferChunk>("getBuffer");
+
+    POTHOS_TEST_EQUAL(inputs.size(), fullOutputs.elements());
+    POTHOS_TEST_EQUAL(inputs.size(), fastOutputs.elements());
+
+    // Single-precision results are close to, but not the same as, the
+    // double-precision ones.
+    const auto* fullBuf = fullOutputs.as<const double*>();
+    const auto* fastBuf = fastOutputs.as<const double*>();
+    size_t numDifferent = 0;
+    for(size_t i = 0; i < inputs.size(); ++i)
+    {
+        POTHOS_TEST_CLOSE(std::sin(-inputs[i]), fullBuf[i], 1e-12);
+        POTHOS_TEST_CLOSE(fullBuf[i], fastBuf[i], 1e-5);
+        if(fullBuf[i] != fastBuf[i])
+        {
+            ++numDifferent;
+        }
+    }
+    POTHOS_TEST_TRUE(numDifferent > 0);
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_fusion)
+{
+    const auto inputs = NPTests::linspace<double>(-5, 5, NumElements);
+
+    std::vector<double> expectedOutputs;
+    for(double input: inputs)
+    {
+        expectedOutputs.emplace_back(std::nearbyint(std::exp(-input)));
+    }
+
+    for(bool fuse: {false, true})
+    {
+        NPTests::testBufferChunk(
+            NPTests::stdVectorToBufferChunk(expectedOutputs),
+            runChain(inputs, fuse));
+        NPTests::testBufferChunk(
+            NPTests::stdVectorToBufferChunk(expectedOutputs),
+            runChainInPlainTopology(inputs, fuse));
+    }
+
+    testFusedSetters(inputs);
+}
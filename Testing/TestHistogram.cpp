@@ -0,0 +1,188 @@
+// Copyright (c) 2019-2020 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "TestUtility.hpp"
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static constexpr size_t NumElements = 2000;
+static constexpr size_t Interval = 250;
+
+// Buffers that don't line up with the interval, so counts must carry over
+static constexpr size_t BufferSize = 97;
+
+// Bins are [edges[i], edges[i+1]), and the last also includes its upper edge.
+static std::vector<double> getExpectedHistograms(
+    const std::vector<double>& inputs,
+    const std::vector<double>& edges,
+    double decay)
+{
+    const size_t numBins = edges.size() - 1;
+
+    std::vector<double> expectedOutputs;
+    std::vector<double> counts(numBins, 0.0);
+    for(size_t i = 0; i < inputs.size(); ++i)
+    {
+        const double input = inputs[i];
+        if((input >= edges.front()) && (input <= edges.back()))
+        {
+            const auto upper = std::upper_bound(edges.begin(), edges.end(), input);
+            const size_t bin = std::min<size_t>(std::distance(edges.begin(), upper) - 1, numBins - 1);
+            counts[bin] += 1.0;
+        }
+
+        if(0 == ((i + 1) % Interval))
+        {
+            expectedOutputs.insert(expectedOutputs.end(), counts.begin(), counts.end());
+            for(auto& count: counts) count *= decay;
+        }
+    }
+
+    return expectedOutputs;
+}
+
+static void testHistogram(
+    const std::vector<double>& edges,
+    bool uniform,
+    double decay)
+{
+    std::cout << "Testing /numpy/histogram (" << (uniform ? "uniform" : "non-uniform")
+              << " bins, decay: " << decay << ")" << std::endl;
+
+    const size_t numBins = edges.size() - 1;
+
+    // Values past both ends of the bins, which aren't counted
+    std::vector<double> inputs;
+    for(size_t i = 0; i < NumElements; ++i)
+    {
+        inputs.emplace_back(1.5 * std::sin(0.01 * i * i));
+    }
+
+    // Values on and next to each edge, which rounding can put in the wrong
+    // bin
+    for(size_t i = 0; i < edges.size(); ++i)
+    {
+        inputs[3*i] = std::nextafter(edges[i], -HUGE_VAL);
+        inputs[(3*i)+1] = edges[i];
+        inputs[(3*i)+2] = std::nextafter(edges[i], HUGE_VAL);
+    }
+
+    auto histogram = Pothos::BlockRegistry::make(
+                         "/numpy/histogram",
+                         "float64",
+                         numBins,
+                         edges.front(),
+                         edges.back(),
+                         Interval,
+                         decay,
+                         "VECTOR");
+    if(!uniform) histogram.call("setBinEdges", edges);
+    POTHOS_TEST_EQUAL(numBins, histogram.call<size_t>("numBins"));
+    POTHOS_TEST_EQUAL(Interval, histogram.call<size_t>("interval"));
+    POTHOS_TEST_EQUAL(decay, histogram.call<double>("decay"));
+
+    const auto collectors = NPTests::runBlock(
+                                histogram,
+                                {NPTests::feedInChunks(inputs, BufferSize)},
+                                {Pothos::DType("float64", numBins)});
+
+    auto outputs = collectors[0].call<Pothos::BufferChunk>("getBuffer");
+    outputs.dtype = Pothos::DType(outputs.dtype.name());
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(getExpectedHistograms(inputs, edges, decay)),
+        outputs);
+}
+
+static void testBinCount()
+{
+    std::cout << "Testing /numpy/bincount (labels)" << std::endl;
+
+    static constexpr size_t numBins = 10;
+
+    // Includes values past the last bin, which aren't counted
+    std::vector<std::uint8_t> inputs;
+    for(size_t i = 0; i < NumElements; ++i)
+    {
+        inputs.emplace_back(std::uint8_t((i * 7) % 13));
+    }
+
+    auto bincount = Pothos::BlockRegistry::make(
+                        "/numpy/bincount",
+                        "uint8",
+                        numBins,
+                        Interval,
+                        1.0,
+                        "LABEL");
+
+    const auto collector = NPTests::runBlock(
+                               bincount,
+                               {NPTests::feedInChunks(inputs, BufferSize)},
+                               {Pothos::DType("uint8")})[0];
+
+    // The input is forwarded, with a label on the last value of each interval.
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(inputs),
+        collector.call("getBuffer"));
+
+    const auto labels = collector.call<std::vector<Pothos::Label>>("getLabels");
+    POTHOS_TEST_EQUAL(NumElements / Interval, labels.size());
+    for(size_t i = 0; i < labels.size(); ++i)
+    {
+        POTHOS_TEST_EQUAL("HISTOGRAM", labels[i].id);
+        POTHOS_TEST_EQUAL(((i + 1) * Interval) - 1, labels[i].index);
+    }
+
+    std::vector<double> expectedCounts(numBins, 0.0);
+    for(auto input: inputs)
+    {
+        if(input < numBins) expectedCounts[input] += 1.0;
+    }
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedCounts),
+        NPTests::stdVectorToBufferChunk(bincount.call<std::vector<double>>("counts")));
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_histogram)
+{
+    const auto uniformEdges = NPTests::linspace<double>(-1.0, 1.0, 9);
+    const std::vector<double> nonUniformEdges{-1.0, -0.5, -0.1, 0.0, 0.05, 0.3, 1.0};
+
+    for(double decay: {1.0, 0.5, 0.0})
+    {
+        testHistogram(uniformEdges, true, decay);
+        testHistogram(nonUniformEdges, false, decay);
+    }
+
+    testBinCount();
+
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make(
+            "/numpy/histogram",
+            "float64",
+            8,
+            -1.0,
+            1.0,
+            Interval,
+            1.5,
+            "VECTOR"),
+        Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make(
+            "/numpy/bincount",
+            "float64",
+            8,
+            Interval,
+            1.0,
+            "VECTOR"),
+        Pothos::ProxyExceptionMessage);
+}
@@ -239,3 +239,42 @@ POTHOS_TEST_BLOCK("/numpy/tests", test_labels)
         }
     }
 }
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_median_even_length)
+{
+    const auto dtype = Pothos::DType("float64");
+
+    // The median of an even number of values is between the middle two, so
+    // its label is at the lower one's index.
+    const std::vector<double> inputs{4.0, -1.0, 8.0, 2.0, 7.0, 3.0};
+    static constexpr double expectedMedian = 3.5;
+    static constexpr size_t expectedMedianPosition = 5;
+
+    auto vectorSource = Pothos::BlockRegistry::make(
+                            "/blocks/vector_source",
+                            dtype);
+    vectorSource.call("setMode", "ONCE");
+    vectorSource.call("setElements", inputs);
+
+    auto median = Pothos::BlockRegistry::make("/numpy/median", dtype, false);
+
+    auto collectorSink = Pothos::BlockRegistry::make(
+                             "/blocks/collector_sink",
+                             dtype);
+
+    {
+        Pothos::Topology topology;
+        topology.connect(vectorSource, 0, median, 0);
+        topology.connect(median, 0, collectorSink, 0);
+        topology.commit();
+
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01, 0.0));
+    }
+
+    auto labels = collectorSink.call<std::vector<Pothos::Label>>("getLabels");
+    POTHOS_TEST_EQUAL(1, labels.size());
+    POTHOS_TEST_EQUAL("MEDIAN", labels[0].id);
+    POTHOS_TEST_EQUAL(expectedMedianPosition, labels[0].index);
+    NPTests::testEqual(expectedMedian, labels[0].data.convert<double>());
+    NPTests::testEqual(expectedMedian, median.call<double>("lastValue"));
+}
@@ -384,6 +384,193 @@ static void testNpySource(const std::string& type)
     testNpySource2D(type);
 }
 
+static void testNpySourcePlayback(const std::string& type)
+{
+    static constexpr size_t playbackStart = 64;
+    static constexpr size_t playbackStop = 128;
+    static constexpr size_t seekIndex = 96;
+
+    const Pothos::DType dtype(type);
+    std::cout << "Testing " << dtype.toString() << " (playback range, seek)..." << std::endl;
+
+    const std::string filepath = getTemporaryTestFile(dtype, ".npy");
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    auto allValues = testFuncs.call<Pothos::BufferChunk>(
+                         "generate1DNpyFile",
+                         filepath,
+                         dtype);
+    POTHOS_TEST_TRUE(Poco::File(filepath).exists());
+
+    auto numpyNpySource = Pothos::BlockRegistry::make(
+                              "/numpy/npy_source",
+                              filepath,
+                              false /*repeat*/);
+    POTHOS_TEST_EQUAL(
+        allValues.elements(),
+        numpyNpySource.call<size_t>("numSamples"));
+
+    numpyNpySource.call("setPlaybackRange", playbackStart, playbackStop);
+    POTHOS_TEST_EQUAL(
+        playbackStart,
+        numpyNpySource.call<size_t>("playbackStart"));
+    POTHOS_TEST_EQUAL(
+        playbackStop,
+        numpyNpySource.call<size_t>("playbackStop"));
+    POTHOS_TEST_EQUAL(
+        playbackStart,
+        numpyNpySource.call<size_t>("position"));
+
+    // Seeking outside of the playback range is an error.
+    POTHOS_TEST_THROWS(
+        numpyNpySource.call("seek", playbackStop),
+        Pothos::ProxyExceptionMessage);
+
+    numpyNpySource.call("seek", seekIndex);
+    POTHOS_TEST_EQUAL(
+        seekIndex,
+        numpyNpySource.call<size_t>("position"));
+
+    auto expectedOutputs = allValues;
+    expectedOutputs.address += (seekIndex * dtype.size());
+    expectedOutputs.length = ((playbackStop - seekIndex) * dtype.size());
+
+    test1DSource(
+        numpyNpySource,
+        expectedOutputs);
+}
+
+static void testNpySourceCachedRepeat(const std::string& type)
+{
+    static constexpr size_t numPasses = 2;
+
+    const Pothos::DType dtype(type);
+    std::cout << "Testing " << dtype.toString() << " (cached repeat)..." << std::endl;
+
+    const std::string filepath = getTemporaryTestFile(dtype, ".npy");
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    auto expectedOutputs = testFuncs.call<Pothos::BufferChunk>(
+                               "generate1DNpyFile",
+                               filepath,
+                               dtype);
+    POTHOS_TEST_TRUE(Poco::File(filepath).exists());
+
+    auto numpyNpySource = Pothos::BlockRegistry::make(
+                              "/numpy/npy_source",
+                              filepath,
+                              true /*repeat*/);
+    numpyNpySource.call("setCacheBuffers", true);
+    POTHOS_TEST_TRUE(numpyNpySource.call<bool>("cacheBuffers"));
+
+    auto collectorSink = Pothos::BlockRegistry::make(
+                             "/blocks/collector_sink",
+                             dtype);
+
+    // Execute the topology.
+    {
+        Pothos::Topology topology;
+        topology.connect(
+            numpyNpySource, 0,
+            collectorSink, 0);
+
+        topology.commit();
+
+        // When this block exits, the flowgraph will stop.
+        Poco::Thread::sleep(10);
+    }
+
+    // Every pass should have the same contents as the file.
+    const auto outputs = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    POTHOS_TEST_GE(outputs.elements(), (numPasses * expectedOutputs.elements()));
+
+    for(size_t pass = 0; pass < numPasses; ++pass)
+    {
+        auto passOutputs = outputs;
+        passOutputs.address += (pass * expectedOutputs.length);
+        passOutputs.length = expectedOutputs.length;
+
+        NPTests::testBufferChunk(
+            expectedOutputs,
+            passOutputs);
+    }
+}
+
+//
+// A rate-limited source should output close to the rate, never ahead of it,
+// and the samples should be unchanged.
+//
+static void testNpySourceRate(
+    const std::string& type,
+    bool cacheBuffers)
+{
+    static constexpr double rate = 20000.0;
+    static constexpr long runTimeMs = 250;
+
+    const Pothos::DType dtype(type);
+    std::cout << "Testing " << dtype.toString() << " (rate, cached: " << (cacheBuffers ? "true" : "false") << ")..." << std::endl;
+
+    const std::string filepath = getTemporaryTestFile(dtype, ".npy");
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    auto expectedOutputs = testFuncs.call<Pothos::BufferChunk>(
+                               "generate1DNpyFile",
+                               filepath,
+                               dtype);
+    POTHOS_TEST_TRUE(Poco::File(filepath).exists());
+
+    auto numpyNpySource = Pothos::BlockRegistry::make(
+                              "/numpy/npy_source",
+                              filepath,
+                              true /*repeat*/);
+    numpyNpySource.call("setCacheBuffers", cacheBuffers);
+    numpyNpySource.call("setRate", rate);
+    POTHOS_TEST_EQUAL(
+        rate,
+        numpyNpySource.call<double>("rate"));
+
+    // Negative rates are an error.
+    POTHOS_TEST_THROWS(
+        numpyNpySource.call("setRate", -1.0),
+        Pothos::ProxyExceptionMessage);
+
+    auto collectorSink = Pothos::BlockRegistry::make(
+                             "/blocks/collector_sink",
+                             dtype);
+
+    // Execute the topology, timing everything from before the source is
+    // activated to after it's stopped.
+    Poco::Timestamp startTime;
+    {
+        Pothos::Topology topology;
+        topology.connect(
+            numpyNpySource, 0,
+            collectorSink, 0);
+
+        topology.commit();
+        Poco::Thread::sleep(runTimeMs);
+    }
+    const double elapsedSeconds = startTime.elapsed() / 1e6;
+
+    const auto outputs = collectorSink.call<Pothos::BufferChunk>("getBuffer");
+    std::cout << " * " << outputs.elements() << " samples in " << elapsedSeconds << " seconds" << std::endl;
+
+    POTHOS_TEST_LE(double(outputs.elements()), (rate * elapsedSeconds));
+    POTHOS_TEST_GE(double(outputs.elements()), (0.5 * rate * (runTimeMs / 1e3)));
+
+    auto passOutputs = outputs;
+    passOutputs.length = expectedOutputs.length;
+    NPTests::testBufferChunk(
+        expectedOutputs,
+        passOutputs);
+}
+
 static void testNpySink(const std::string& type)
 {
     static constexpr size_t numElements = 256;
@@ -439,6 +626,102 @@ static void testNpySink(const std::string& type)
     testFuncs.call("checkNpyContents", filepath, randomInputs);
 }
 
+static void testNpyHalfPrecision()
+{
+    static constexpr size_t numElements = 256;
+
+    const Pothos::DType dtype("float32");
+    std::cout << "Testing float16 storage..." << std::endl;
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    //
+    // A float16 file should be read as float32.
+    //
+
+    const std::string sourceFilepath = getTemporaryTestFile(".npy");
+    auto expectedOutputs = testFuncs.call(
+                               "generate1DHalfPrecisionNpyFile",
+                               sourceFilepath);
+    POTHOS_TEST_TRUE(Poco::File(sourceFilepath).exists());
+
+    auto numpyNpySource = Pothos::BlockRegistry::make(
+                              "/numpy/npy_source",
+                              sourceFilepath,
+                              false /*repeat*/);
+    POTHOS_TEST_EQUAL(
+        dtype.name(),
+        numpyNpySource.call("output", 0)
+                      .get("_port")
+                      .call("dtype")
+                      .call<std::string>("name"));
+
+    test1DSource(
+        numpyNpySource,
+        expectedOutputs);
+
+    //
+    // Write float32 values as float16, which should halve the file size.
+    //
+
+    const std::string sinkFilepath = getTemporaryTestFile(".npy");
+
+    // Values within float16's range, including some of its subnormals
+    static constexpr size_t numSubnormals = 8;
+    auto inputValues = NPTests::linspace<float>(-60000.0f, 60000.0f, numElements - numSubnormals);
+    for(size_t i = 1; i <= (numSubnormals / 2); ++i)
+    {
+        inputValues.emplace_back(i * 6e-8f);
+        inputValues.emplace_back(i * -6e-8f);
+    }
+    const auto inputs = NPTests::stdVectorToBufferChunk(inputValues);
+
+    auto feederSource = Pothos::BlockRegistry::make(
+                            "/blocks/feeder_source",
+                            dtype);
+    feederSource.call("feedBuffer", inputs);
+
+    auto numpySave = Pothos::BlockRegistry::make(
+                         "/numpy/npy_sink",
+                         sinkFilepath,
+                         dtype,
+                         1 /*nchans*/,
+                         false /*append*/);
+    numpySave.call("setStorageDType", "float16");
+    POTHOS_TEST_EQUAL(
+        "float16",
+        numpySave.call<std::string>("storageDType"));
+
+    // Integers can't be stored at a lower precision.
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make(
+            "/numpy/npy_sink",
+            sinkFilepath,
+            "int16",
+            1 /*nchans*/,
+            false /*append*/).call("setStorageDType", "float16"),
+        Pothos::ProxyExceptionMessage);
+
+    // Execute the topology.
+    {
+        Pothos::Topology topology;
+        topology.connect(
+            feederSource, 0,
+            numpySave, 0);
+
+        topology.commit();
+
+        // When this block exits, the flowgraph will stop.
+        Poco::Thread::sleep(10);
+    }
+
+    POTHOS_TEST_TRUE(Poco::File(sinkFilepath).exists());
+    POTHOS_TEST_LT(Poco::File(sinkFilepath).getSize(), (numElements * dtype.elemSize()));
+
+    testFuncs.call("checkHalfPrecisionNpyContents", sinkFilepath, inputs);
+}
+
 static void testNpzSource1D(
     const std::string& filepath,
     const std::string& key,
@@ -538,6 +821,79 @@ static void testNpzSource(bool compressed)
     }
 }
 
+static void testNpzSourcePlayback(bool compressed)
+{
+    // The samples span several of the 1 MiB chunks the source decodes.
+    static constexpr size_t playbackStart = 100000;
+    static constexpr size_t playbackStop = 350000;
+    static constexpr size_t seekIndex = 200000;
+    static const std::string key = "values";
+
+    const Pothos::DType dtype("float64");
+    std::cout << "Testing " << (compressed ? "compressed" : "uncompressed")
+              << " .npz file (playback range, seek)..." << std::endl;
+
+    const std::string filepath = getTemporaryTestFile(".npz");
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    auto allValues = testFuncs.call<Pothos::BufferChunk>(
+                         "generateLargeNpzFile",
+                         filepath,
+                         key,
+                         compressed);
+    POTHOS_TEST_TRUE(Poco::File(filepath).exists());
+
+    auto numpyNpzSource = Pothos::BlockRegistry::make(
+                              "/numpy/npz_source",
+                              filepath,
+                              key,
+                              false /*repeat*/);
+    POTHOS_TEST_EQUAL(
+        allValues.elements(),
+        numpyNpzSource.call<size_t>("numSamples"));
+
+    numpyNpzSource.call("setPlaybackRange", playbackStart, playbackStop);
+    POTHOS_TEST_EQUAL(
+        playbackStart,
+        numpyNpzSource.call<size_t>("position"));
+
+    // Seeking outside of the playback range is an error.
+    POTHOS_TEST_THROWS(
+        numpyNpzSource.call("seek", playbackStop),
+        Pothos::ProxyExceptionMessage);
+
+    numpyNpzSource.call("seek", seekIndex);
+    POTHOS_TEST_EQUAL(
+        seekIndex,
+        numpyNpzSource.call<size_t>("position"));
+
+    auto collectorSink = Pothos::BlockRegistry::make(
+                             "/blocks/collector_sink",
+                             dtype);
+
+    // Decoding takes longer than for the small test files, so wait for the
+    // source to finish.
+    {
+        Pothos::Topology topology;
+        topology.connect(
+            numpyNpzSource, 0,
+            collectorSink, 0);
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.1, 10.0));
+    }
+
+    auto expectedOutputs = allValues;
+    expectedOutputs.address += (seekIndex * dtype.size());
+    expectedOutputs.length = ((playbackStop - seekIndex) * dtype.size());
+
+    NPTests::testBufferChunk(
+        expectedOutputs,
+        collectorSink.call("getBuffer"));
+}
+
 static void testNpzSink(
     const std::string& filepath,
     const std::string& key,
@@ -676,6 +1032,207 @@ static void testNpzSink(bool compressed)
         npzTestInputsToProxyMap(testInputs));
 }
 
+static void testLoadTxtSource(const std::string& type)
+{
+    const std::string delimiter = ",";
+
+    const Pothos::DType dtype(type);
+    std::cout << "Testing " << dtype.toString() << std::endl;
+
+    const std::string filepath = getTemporaryTestFile(dtype, ".csv");
+
+    //
+    // Generate our test file in NumPy and save our expected values.
+    //
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    auto expectedOutputs = convert2DNumPyArrayToBufferChunks(testFuncs.call(
+                               "generate2DTxtFile",
+                               filepath,
+                               dtype,
+                               delimiter));
+    POTHOS_TEST_TRUE(Poco::File(filepath).exists());
+
+    auto numpyLoadTxt = Pothos::BlockRegistry::make(
+                            "/numpy/loadtxt",
+                            filepath,
+                            dtype,
+                            delimiter,
+                            "#" /*comments*/,
+                            1 /*skiprows*/,
+                            false /*repeat*/);
+    POTHOS_TEST_EQUAL(
+        filepath,
+        numpyLoadTxt.call<std::string>("filepath"));
+    POTHOS_TEST_EQUAL(
+        kNumChannels,
+        numpyLoadTxt.call<size_t>("numColumns"));
+
+    test2DSource(
+        numpyLoadTxt,
+        expectedOutputs);
+}
+
+//
+// The file is read in chunks far smaller than a line, so lines straddle
+// chunks and some chunks hold no whole line at all, and playback repeats.
+//
+static void testLoadTxtSourceChunkedRepeat(const std::string& type)
+{
+    static constexpr size_t numPasses = 2;
+    static constexpr size_t chunkBytes = 37;
+    const std::string delimiter = ",";
+
+    const Pothos::DType dtype(type);
+    std::cout << "Testing " << dtype.toString() << " (chunked repeat)..." << std::endl;
+
+    const std::string filepath = getTemporaryTestFile(dtype, ".csv");
+
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    auto expectedOutputs = convert2DNumPyArrayToBufferChunks(testFuncs.call(
+                               "generate2DTxtFile",
+                               filepath,
+                               dtype,
+                               delimiter));
+    POTHOS_TEST_TRUE(Poco::File(filepath).exists());
+
+    auto numpyLoadTxt = Pothos::BlockRegistry::make(
+                            "/numpy/loadtxt",
+                            filepath,
+                            dtype,
+                            delimiter,
+                            "#" /*comments*/,
+                            1 /*skiprows*/,
+                            true /*repeat*/);
+    numpyLoadTxt.set("ChunkBytes", chunkBytes);
+
+    std::vector<Pothos::Proxy> collectorSinks;
+    for(size_t port = 0; port < kNumChannels; ++port)
+    {
+        collectorSinks.emplace_back(Pothos::BlockRegistry::make(
+                                        "/blocks/collector_sink",
+                                        dtype));
+    }
+
+    // Execute the topology until every port has enough passes.
+    const size_t minElements = numPasses * expectedOutputs[0].elements();
+    auto numCollected = [&]()
+    {
+        size_t minCollected = minElements;
+        for(const auto& collectorSink: collectorSinks)
+        {
+            minCollected = std::min(
+                               minCollected,
+                               collectorSink.call<Pothos::BufferChunk>("getBuffer").elements());
+        }
+        return minCollected;
+    };
+    {
+        Pothos::Topology topology;
+
+        for(size_t port = 0; port < kNumChannels; ++port)
+        {
+            topology.connect(
+                numpyLoadTxt, port,
+                collectorSinks[port], 0);
+        }
+
+        topology.commit();
+
+        for(size_t i = 0; (i < 500) && (numCollected() < minElements); ++i)
+        {
+            Poco::Thread::sleep(10);
+        }
+    }
+
+    // Every pass should have the same contents as the file.
+    for(size_t port = 0; port < kNumChannels; ++port)
+    {
+        const auto outputs = collectorSinks[port].call<Pothos::BufferChunk>("getBuffer");
+        POTHOS_TEST_GE(outputs.elements(), minElements);
+
+        for(size_t pass = 0; pass < numPasses; ++pass)
+        {
+            auto passOutputs = outputs;
+            passOutputs.address += (pass * expectedOutputs[port].length);
+            passOutputs.length = expectedOutputs[port].length;
+
+            NPTests::testBufferChunk(
+                expectedOutputs[port],
+                passOutputs);
+        }
+    }
+}
+
+static void testSaveTxtSink(
+    const std::string& type,
+    size_t nchans = 1,
+    const std::string& delimiter = ",")
+{
+    static constexpr size_t numElements = 256;
+
+    const Pothos::DType dtype(type);
+    std::cout << "Testing " << dtype.toString() << " (" << nchans << " channels, delimiter: \"" << delimiter << "\")" << std::endl;
+
+    const std::string filepath = getTemporaryTestFile(dtype, ".csv");
+    const auto randomInputs = getRandomInputs(type, numElements);
+
+    //
+    // Write known values to the text file. Every channel is given the same
+    // values.
+    //
+
+    std::vector<Pothos::Proxy> feederSources;
+    for(size_t chan = 0; chan < nchans; ++chan)
+    {
+        feederSources.emplace_back(Pothos::BlockRegistry::make(
+                                       "/blocks/feeder_source",
+                                       dtype));
+        feederSources.back().call("feedBuffer", randomInputs);
+    }
+
+    auto numpySaveTxt = Pothos::BlockRegistry::make(
+                            "/numpy/savetxt",
+                            filepath,
+                            dtype,
+                            nchans,
+                            delimiter,
+                            "" /*fmt*/);
+    POTHOS_TEST_EQUAL(
+        filepath,
+        numpySaveTxt.call<std::string>("filepath"));
+
+    // Execute the topology.
+    {
+        Pothos::Topology topology;
+        for(size_t chan = 0; chan < nchans; ++chan)
+        {
+            topology.connect(
+                feederSources[chan], 0,
+                numpySaveTxt, chan);
+        }
+
+        topology.commit();
+
+        // When this block exits, the flowgraph will stop.
+        Poco::Thread::sleep(10);
+    }
+
+    POTHOS_TEST_TRUE(Poco::File(filepath).exists());
+
+    //
+    // Use NumPy directly to test our values.
+    //
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    testFuncs.call("checkTxtContents", filepath, delimiter, randomInputs, nchans);
+}
+
 //
 // Registered tests
 //
@@ -696,6 +1253,20 @@ POTHOS_TEST_BLOCK("/numpy/tests", test_npy_source)
     testNpySource("complex_float64");
 }
 
+POTHOS_TEST_BLOCK("/numpy/tests", test_npy_source_playback)
+{
+    testNpySourcePlayback("int16");
+    testNpySourcePlayback("float32");
+    testNpySourcePlayback("complex_float64");
+
+    testNpySourceCachedRepeat("int16");
+    testNpySourceCachedRepeat("float32");
+    testNpySourceCachedRepeat("complex_float64");
+
+    testNpySourceRate("float32", false /*cacheBuffers*/);
+    testNpySourceRate("float32", true /*cacheBuffers*/);
+}
+
 POTHOS_TEST_BLOCK("/numpy/tests", test_npy_sink)
 {
     testNpySink("int8");
@@ -712,10 +1283,18 @@ POTHOS_TEST_BLOCK("/numpy/tests", test_npy_sink)
     testNpySink("complex_float64");
 }
 
+POTHOS_TEST_BLOCK("/numpy/tests", test_npy_half_precision)
+{
+    testNpyHalfPrecision();
+}
+
 POTHOS_TEST_BLOCK("/numpy/tests", test_npz_source)
 {
     testNpzSource(false /*compressed*/);
     testNpzSource(true /*compressed*/);
+
+    testNpzSourcePlayback(false /*compressed*/);
+    testNpzSourcePlayback(true /*compressed*/);
 }
 
 POTHOS_TEST_BLOCK("/numpy/tests", test_npz_sink)
@@ -723,3 +1302,38 @@ POTHOS_TEST_BLOCK("/numpy/tests", test_npz_sink)
     testNpzSink(false /*compressed*/);
     testNpzSink(true /*compressed*/);
 }
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_loadtxt)
+{
+    testLoadTxtSource("int8");
+    testLoadTxtSource("int16");
+    testLoadTxtSource("int32");
+    testLoadTxtSource("int64");
+    testLoadTxtSource("uint8");
+    testLoadTxtSource("uint16");
+    testLoadTxtSource("uint32");
+    testLoadTxtSource("uint64");
+    testLoadTxtSource("float32");
+    testLoadTxtSource("float64");
+
+    testLoadTxtSourceChunkedRepeat("int16");
+    testLoadTxtSourceChunkedRepeat("float64");
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_savetxt)
+{
+    testSaveTxtSink("int8");
+    testSaveTxtSink("int16");
+    testSaveTxtSink("int32");
+    testSaveTxtSink("int64");
+    testSaveTxtSink("uint8");
+    testSaveTxtSink("uint16");
+    testSaveTxtSink("uint32");
+    testSaveTxtSink("uint64");
+    testSaveTxtSink("float32");
+    testSaveTxtSink("float64");
+
+    // The delimiter is part of a printf-style format string.
+    testSaveTxtSink("int32", kNumChannels, "%");
+    testSaveTxtSink("float64", kNumChannels, "%");
+}
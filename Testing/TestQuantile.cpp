@@ -0,0 +1,160 @@
+// Copyright (c) 2019-2020 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "TestUtility.hpp"
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static constexpr size_t NumElements = 10000;
+static constexpr size_t Interval = 1000;
+
+// Buffers that don't line up with the interval, so state must carry over
+static constexpr size_t BufferSize = 337;
+
+static std::vector<double> getInputs()
+{
+    // A shuffled ramp, so the expected quantiles are easy to reason about
+    std::vector<double> inputs;
+    for(size_t i = 0; i < NumElements; ++i)
+    {
+        inputs.emplace_back(double((i * 7919) % NumElements));
+    }
+
+    return inputs;
+}
+
+// Linear interpolation between the two nearest values, as with numpy.quantile
+static double quantile(std::vector<double> values, double q)
+{
+    std::sort(values.begin(), values.end());
+
+    const double position = q * (values.size() - 1);
+    const size_t lower = size_t(std::floor(position));
+    const size_t upper = std::min(lower + 1, values.size() - 1);
+
+    return values[lower] + ((values[upper] - values[lower]) * (position - lower));
+}
+
+static Pothos::Proxy runBlock(
+    const Pothos::Proxy& block,
+    const std::vector<double>& inputs)
+{
+    const auto collector = NPTests::runBlock(
+                               block,
+                               {NPTests::feedInChunks(inputs, BufferSize)},
+                               {Pothos::DType("float64")})[0];
+
+    // The input is forwarded, with a label on the last value of each interval.
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(inputs),
+        collector.call("getBuffer"));
+
+    return collector;
+}
+
+static void testExact(const std::string& blockPath, double scale)
+{
+    std::cout << "Testing " << blockPath << " (exact)" << std::endl;
+
+    const std::vector<double> quantiles{0.0, 0.1, 0.5, 0.95, 1.0};
+    std::vector<double> scaledQuantiles;
+    for(double q: quantiles) scaledQuantiles.emplace_back(q * scale);
+
+    const auto inputs = getInputs();
+
+    auto block = Pothos::BlockRegistry::make(
+                     blockPath,
+                     "float64",
+                     scaledQuantiles,
+                     Interval,
+                     "EXACT",
+                     100);
+    POTHOS_TEST_EQUAL(Interval, block.call<size_t>("interval"));
+    POTHOS_TEST_EQUAL("EXACT", block.call<std::string>("mode"));
+
+    auto collector = runBlock(block, inputs);
+
+    const auto labels = collector.call<std::vector<Pothos::Label>>("getLabels");
+    POTHOS_TEST_EQUAL(NumElements / Interval, labels.size());
+    for(size_t i = 0; i < labels.size(); ++i)
+    {
+        POTHOS_TEST_EQUAL(((i + 1) * Interval) - 1, labels[i].index);
+    }
+
+    // The last label only covers the last interval.
+    const std::vector<double> lastInterval(inputs.end() - Interval, inputs.end());
+    std::vector<double> expectedValues;
+    for(double q: quantiles) expectedValues.emplace_back(quantile(lastInterval, q));
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedValues),
+        NPTests::stdVectorToBufferChunk(block.call<std::vector<double>>("lastValue")));
+}
+
+static void testTDigest()
+{
+    std::cout << "Testing /numpy/quantile (t-digest)" << std::endl;
+
+    const std::vector<double> quantiles{0.01, 0.25, 0.5, 0.75, 0.99};
+    const auto inputs = getInputs();
+
+    auto block = Pothos::BlockRegistry::make(
+                     "/numpy/quantile",
+                     "float64",
+                     quantiles,
+                     Interval,
+                     "TDIGEST",
+                     100);
+    POTHOS_TEST_EQUAL(100, block.call<size_t>("compression"));
+
+    auto collector = runBlock(block, inputs);
+    POTHOS_TEST_EQUAL(
+        NumElements / Interval,
+        collector.call<std::vector<Pothos::Label>>("getLabels").size());
+
+    // The last label covers the whole stream, and the estimates should be
+    // within a small fraction of the range of the exact values.
+    const auto values = block.call<std::vector<double>>("lastValue");
+    POTHOS_TEST_EQUAL(quantiles.size(), values.size());
+    for(size_t i = 0; i < quantiles.size(); ++i)
+    {
+        POTHOS_TEST_CLOSE(
+            quantile(inputs, quantiles[i]),
+            values[i],
+            0.005 * NumElements);
+    }
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_quantile)
+{
+    testExact("/numpy/quantile", 1.0);
+    testExact("/numpy/percentile", 100.0);
+    testTDigest();
+
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make(
+            "/numpy/quantile",
+            "float64",
+            std::vector<double>{0.5, 1.5},
+            Interval,
+            "TDIGEST",
+            100),
+        Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make(
+            "/numpy/percentile",
+            "float64",
+            std::vector<double>{50.0},
+            Interval,
+            "SORT",
+            100),
+        Pothos::ProxyExceptionMessage);
+}
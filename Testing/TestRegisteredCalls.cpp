@@ -145,4 +145,103 @@ POTHOS_TEST_BLOCK("/numpy/tests", test_registered_string_calls)
     auto json = nlohmann::json::parse(numpyConfigInfo);
 
     std::cout << json.dump() << std::endl;
+
+    std::string numpyCPUInfo = NPTests::getAndCallPlugin<std::string>("/devices/numpy/cpu_info");
+    POTHOS_TEST_FALSE(numpyCPUInfo.empty());
+    json = nlohmann::json::parse(numpyCPUInfo);
+
+    std::cout << json.dump() << std::endl;
+
+    std::string numpyThreadInfo = NPTests::getAndCallPlugin<std::string>("/devices/numpy/thread_info");
+    POTHOS_TEST_FALSE(numpyThreadInfo.empty());
+    json = nlohmann::json::parse(numpyThreadInfo);
+
+    std::cout << json.dump() << std::endl;
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_registered_thread_calls)
+{
+    auto getThreadInfo = []()
+    {
+        return nlohmann::json::parse(NPTests::getAndCallPlugin<std::string>("/devices/numpy/thread_info"))["Thread Info"];
+    };
+
+    const auto originalDefaultNumThreads = getThreadInfo()["Default Num Threads"].get<size_t>();
+
+    (void)NPTests::getAndCallPlugin<Pothos::Object>("/numpy/threads/set_default_num_threads", size_t(4));
+    POTHOS_TEST_EQUAL(4, getThreadInfo()["Default Num Threads"].get<size_t>());
+
+    (void)NPTests::getAndCallPlugin<Pothos::Object>("/numpy/threads/set_default_num_threads", originalDefaultNumThreads);
+    POTHOS_TEST_EQUAL(originalDefaultNumThreads, getThreadInfo()["Default Num Threads"].get<size_t>());
+
+    // Backend limits need threadpoolctl, so only test them if it's available.
+    if(getThreadInfo()["Backend Control Available"].get<bool>())
+    {
+        (void)NPTests::getAndCallPlugin<Pothos::Object>("/numpy/threads/set_backend_num_threads", size_t(1));
+        POTHOS_TEST_EQUAL(1, getThreadInfo()["Backend Num Threads Limit"].get<size_t>());
+
+        (void)NPTests::getAndCallPlugin<Pothos::Object>("/numpy/threads/set_backend_num_threads", size_t(0));
+        POTHOS_TEST_EQUAL(0, getThreadInfo()["Backend Num Threads Limit"].get<size_t>());
+    }
+    else
+    {
+        POTHOS_TEST_THROWS(
+            NPTests::getAndCallPlugin<Pothos::Object>("/numpy/threads/set_backend_num_threads", size_t(1)),
+            Pothos::Exception);
+    }
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_block_backend_thread_limits)
+{
+    auto getAppliedLimit = []()
+    {
+        const auto threadInfo = nlohmann::json::parse(NPTests::getAndCallPlugin<std::string>("/devices/numpy/thread_info"))["Thread Info"];
+        return threadInfo["Backend Num Threads Limit"].get<size_t>();
+    };
+    const bool isBackendControlAvailable = nlohmann::json::parse(
+        NPTests::getAndCallPlugin<std::string>("/devices/numpy/thread_info"))["Thread Info"]["Backend Control Available"].get<bool>();
+
+    auto convolve = Pothos::BlockRegistry::make(
+                        "/numpy/convolve",
+                        "float64",
+                        "FULL");
+    auto firFilter = Pothos::BlockRegistry::make(
+                         "/numpy/fir_filter",
+                         "float64",
+                         std::vector<double>{1.0, 0.5},
+                         1,
+                         1);
+    POTHOS_TEST_EQUAL(0, convolve.call<size_t>("backendNumThreads"));
+    POTHOS_TEST_EQUAL(0, getAppliedLimit());
+
+    // Backend limits need threadpoolctl, so only test them if it's available.
+    if(isBackendControlAvailable)
+    {
+        // The backend's thread count is process-wide, so the smallest of the
+        // block and global limits applies.
+        convolve.call("setBackendNumThreads", 3);
+        POTHOS_TEST_EQUAL(3, convolve.call<size_t>("backendNumThreads"));
+        POTHOS_TEST_EQUAL(3, getAppliedLimit());
+
+        firFilter.call("setBackendNumThreads", 2);
+        POTHOS_TEST_EQUAL(2, getAppliedLimit());
+
+        (void)NPTests::getAndCallPlugin<Pothos::Object>("/numpy/threads/set_backend_num_threads", size_t(1));
+        POTHOS_TEST_EQUAL(1, getAppliedLimit());
+        (void)NPTests::getAndCallPlugin<Pothos::Object>("/numpy/threads/set_backend_num_threads", size_t(0));
+        POTHOS_TEST_EQUAL(2, getAppliedLimit());
+
+        // Removing a block's limit leaves the others.
+        firFilter.call("setBackendNumThreads", 0);
+        POTHOS_TEST_EQUAL(3, getAppliedLimit());
+        convolve.call("setBackendNumThreads", 0);
+        POTHOS_TEST_EQUAL(0, getAppliedLimit());
+    }
+    else
+    {
+        POTHOS_TEST_THROWS(
+            convolve.call("setBackendNumThreads", 1),
+            Pothos::ProxyExceptionMessage);
+        POTHOS_TEST_EQUAL(0, convolve.call<size_t>("backendNumThreads"));
+    }
 }
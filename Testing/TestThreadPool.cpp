@@ -0,0 +1,106 @@
+// Copyright (c) 2019-2020 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "TestUtility.hpp"
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// The number of elements blocks split buffers into tiles of
+static constexpr size_t TileElements = 8192;
+
+// Fed as a single buffer, so blocks with more than one thread are given many
+// tiles' worth at once. The default output buffers hold at most one tile, so
+// these blocks post their own output.
+static constexpr size_t NumElements = 200000;
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_run_tiles)
+{
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    // Each call checks that every element is processed once, by as many
+    // workers as there are threads, CPUs, or tiles, whichever is fewest.
+    for(size_t numThreads: {1, 2, 4, 8})
+    {
+        std::cout << "Testing tiles with " << numThreads << " threads..." << std::endl;
+
+        testFuncs.call("checkRunTiles", NumElements, numThreads, TileElements);
+        testFuncs.call("checkRunTiles", TileElements, numThreads, TileElements);
+        testFuncs.call("checkRunTiles", (TileElements + 1), numThreads, TileElements);
+        testFuncs.call("checkRunTiles", (3 * TileElements), numThreads, TileElements);
+    }
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_threaded_random_source)
+{
+    auto env = Pothos::ProxyEnvironment::make("python");
+    auto testFuncs = env->findProxy("PothosNumPy.TestFuncs");
+
+    // Each worker generates its tiles with its own generator.
+    for(size_t numThreads: {1, 4})
+    {
+        std::cout << "Testing /numpy/random/normal with " << numThreads << " threads..." << std::endl;
+        testFuncs.call("checkThreadedRandomSource", numThreads);
+    }
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_thread_pool)
+{
+    const auto inputs0 = NPTests::linspace<double>(-10, 10, NumElements);
+    const auto inputs1 = NPTests::linspace<double>(5, -5, NumElements);
+
+    std::vector<double> expectedArcSinH;
+    std::vector<double> expectedCopySign;
+    for(size_t i = 0; i < NumElements; ++i)
+    {
+        expectedArcSinH.emplace_back(std::asinh(inputs0[i]));
+        expectedCopySign.emplace_back(std::copysign(inputs0[i], inputs1[i]));
+    }
+
+    for(size_t numThreads: {1, 4})
+    {
+        std::cout << "Testing with " << numThreads << " threads..." << std::endl;
+
+        auto arcsinh = Pothos::BlockRegistry::make(
+                           "/numpy/arcsinh",
+                           "float64");
+        arcsinh.call("setNumThreads", numThreads);
+        POTHOS_TEST_EQUAL(
+            numThreads,
+            arcsinh.call<size_t>("numThreads"));
+        NPTests::testBufferChunk(
+            NPTests::stdVectorToBufferChunk(expectedArcSinH),
+            NPTests::runBlock(
+                arcsinh,
+                {NPTests::feedInChunks(inputs0)},
+                {Pothos::DType("float64")})[0].call("getBuffer"));
+
+        auto copysign = Pothos::BlockRegistry::make(
+                            "/numpy/copysign",
+                            "float64");
+        copysign.call("setNumThreads", numThreads);
+        NPTests::testBufferChunk(
+            NPTests::stdVectorToBufferChunk(expectedCopySign),
+            NPTests::runBlock(
+                copysign,
+                {NPTests::feedInChunks(inputs0), NPTests::feedInChunks(inputs1)},
+                {Pothos::DType("float64")})[0].call("getBuffer"));
+    }
+
+    // 0 means the global default, which is 1 unless set.
+    auto block = Pothos::BlockRegistry::make(
+                     "/numpy/arcsinh",
+                     "float64");
+    block.call("setNumThreads", 0);
+    POTHOS_TEST_TRUE(block.call<size_t>("numThreads") >= 1);
+    POTHOS_TEST_THROWS(
+        block.call("setNumThreads", -1),
+        Pothos::ProxyExceptionMessage);
+}
@@ -0,0 +1,179 @@
+// Copyright (c) 2019-2020 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "TestUtility.hpp"
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+static constexpr size_t NumElements = 5000;
+static constexpr size_t K = 8;
+static constexpr size_t Interval = 1000;
+
+// Buffers that don't line up with the interval, so state must carry over
+static constexpr size_t BufferSize = 337;
+
+static std::vector<int> getInputs()
+{
+    // Few distinct values, so there are ties to break
+    std::vector<int> inputs;
+    for(size_t i = 0; i < NumElements; ++i)
+    {
+        inputs.emplace_back(int((i * 7919) % 211) - 105);
+    }
+
+    return inputs;
+}
+
+// Best first, with ties in stream order
+static std::vector<size_t> getExpectedIndices(
+    const std::vector<int>& inputs,
+    size_t numInputs,
+    bool largest)
+{
+    std::vector<size_t> indices(numInputs);
+    std::iota(indices.begin(), indices.end(), 0);
+    std::stable_sort(
+        indices.begin(),
+        indices.end(),
+        [&](size_t lhs, size_t rhs)
+        {
+            return largest ? (inputs[lhs] > inputs[rhs]) : (inputs[lhs] < inputs[rhs]);
+        });
+    indices.resize(K);
+
+    return indices;
+}
+
+static void testTopKVector(const std::string& order)
+{
+    std::cout << "Testing /numpy/top_k (" << order << ", vector)" << std::endl;
+
+    const bool largest = ("LARGEST" == order);
+    const auto inputs = getInputs();
+
+    std::vector<int> expectedValues;
+    std::vector<std::int64_t> expectedIndices;
+    for(size_t output = 1; output <= (NumElements / Interval); ++output)
+    {
+        for(size_t index: getExpectedIndices(inputs, output * Interval, largest))
+        {
+            expectedValues.emplace_back(inputs[index]);
+            expectedIndices.emplace_back(std::int64_t(index));
+        }
+    }
+
+    auto topK = Pothos::BlockRegistry::make(
+                    "/numpy/top_k",
+                    "int32",
+                    K,
+                    order,
+                    Interval,
+                    "VECTOR");
+    POTHOS_TEST_EQUAL(K, topK.call<size_t>("k"));
+    POTHOS_TEST_EQUAL(order, topK.call<std::string>("order"));
+
+    const auto collectors = NPTests::runBlock(
+                                topK,
+                                {NPTests::feedInChunks(inputs, BufferSize)},
+                                {Pothos::DType("int32", K), Pothos::DType("int64", K)});
+
+    auto values = collectors[0].call<Pothos::BufferChunk>("getBuffer");
+    values.dtype = Pothos::DType(values.dtype.name());
+    auto indices = collectors[1].call<Pothos::BufferChunk>("getBuffer");
+    indices.dtype = Pothos::DType(indices.dtype.name());
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedValues),
+        values);
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedIndices),
+        indices);
+}
+
+static void testTopKLabels()
+{
+    std::cout << "Testing /numpy/top_k (labels)" << std::endl;
+
+    const auto inputs = getInputs();
+
+    auto topK = Pothos::BlockRegistry::make(
+                    "/numpy/top_k",
+                    "int32",
+                    K,
+                    "LARGEST",
+                    Interval,
+                    "LABEL");
+
+    const auto collector = NPTests::runBlock(
+                               topK,
+                               {NPTests::feedInChunks(inputs, BufferSize)},
+                               {Pothos::DType("int32")})[0];
+
+    // The input is forwarded, with two labels on the last value of each
+    // interval.
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(inputs),
+        collector.call("getBuffer"));
+
+    const auto labels = collector.call<std::vector<Pothos::Label>>("getLabels");
+    POTHOS_TEST_EQUAL(2 * (NumElements / Interval), labels.size());
+    for(size_t i = 0; i < labels.size(); i += 2)
+    {
+        const size_t expectedIndex = (((i / 2) + 1) * Interval) - 1;
+
+        POTHOS_TEST_EQUAL("TOP_K", labels[i].id);
+        POTHOS_TEST_EQUAL(expectedIndex, labels[i].index);
+        POTHOS_TEST_EQUAL("TOP_K_INDICES", labels[i+1].id);
+        POTHOS_TEST_EQUAL(expectedIndex, labels[i+1].index);
+    }
+
+    std::vector<int> expectedValues;
+    std::vector<std::int64_t> expectedIndices;
+    for(size_t index: getExpectedIndices(inputs, NumElements, true))
+    {
+        expectedValues.emplace_back(inputs[index]);
+        expectedIndices.emplace_back(std::int64_t(index));
+    }
+
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedValues),
+        NPTests::stdVectorToBufferChunk(topK.call<std::vector<int>>("values")));
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedIndices),
+        NPTests::stdVectorToBufferChunk(topK.call<std::vector<std::int64_t>>("indices")));
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_top_k)
+{
+    testTopKVector("LARGEST");
+    testTopKVector("SMALLEST");
+    testTopKLabels();
+
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make(
+            "/numpy/top_k",
+            "complex_float64",
+            K,
+            "LARGEST",
+            Interval,
+            "VECTOR"),
+        Pothos::ProxyExceptionMessage);
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make(
+            "/numpy/top_k",
+            "int32",
+            0,
+            "LARGEST",
+            Interval,
+            "VECTOR"),
+        Pothos::ProxyExceptionMessage);
+}
@@ -3,8 +3,12 @@
 
 #include "TestUtility.hpp"
 
+#include <Pothos/Framework.hpp>
 #include <Pothos/Testing.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 namespace NPTests
 {
 
@@ -68,10 +72,74 @@ void testBufferChunk(
     IfTypeThenCompare("uint16", std::uint16_t)
     IfTypeThenCompare("uint32", std::uint32_t)
     IfTypeThenCompare("uint64", std::uint64_t)
+    IfTypeThenCompare("complex_int8", std::complex<std::int8_t>)
+    IfTypeThenCompare("complex_int16", std::complex<std::int16_t>)
+    IfTypeThenCompare("complex_int32", std::complex<std::int32_t>)
+    IfTypeThenCompare("complex_int64", std::complex<std::int64_t>)
     IfTypeThenCompareFloat("float32", float)
     IfTypeThenCompareFloat("float64", double)
     IfTypeThenCompareComplex("complex_float32", std::complex<float>)
     IfTypeThenCompareComplex("complex_float64", std::complex<double>)
 }
 
+Pothos::Proxy feedInChunks(
+    const Pothos::BufferChunk& inputs,
+    size_t chunkSize)
+{
+    auto feeder = Pothos::BlockRegistry::make(
+                      "/blocks/feeder_source",
+                      inputs.dtype);
+    if(0 == chunkSize) chunkSize = std::max<size_t>(inputs.elements(), 1);
+
+    const size_t elementSize = inputs.dtype.size();
+    for(size_t start = 0; start < inputs.elements(); start += chunkSize)
+    {
+        const size_t length = std::min(chunkSize, inputs.elements() - start);
+
+        Pothos::BufferChunk chunk(inputs.dtype, length);
+        std::memcpy(
+            chunk.as<void*>(),
+            inputs.as<const char*>() + (start * elementSize),
+            chunk.length);
+        feeder.call("feedBuffer", chunk);
+    }
+
+    return feeder;
+}
+
+std::vector<Pothos::Proxy> runBlock(
+    const Pothos::Proxy& block,
+    const std::vector<Pothos::Proxy>& feeders,
+    const std::vector<Pothos::DType>& outputDTypes)
+{
+    std::vector<Pothos::Proxy> collectors;
+    for(const auto& dtype: outputDTypes)
+    {
+        collectors.emplace_back(Pothos::BlockRegistry::make(
+                                    "/blocks/collector_sink",
+                                    dtype));
+    }
+
+    {
+        Pothos::Topology topology;
+        for(size_t chan = 0; chan < feeders.size(); ++chan)
+        {
+            topology.connect(
+                feeders[chan], 0,
+                block, chan);
+        }
+        for(size_t chan = 0; chan < collectors.size(); ++chan)
+        {
+            topology.connect(
+                block, chan,
+                collectors[chan], 0);
+        }
+
+        topology.commit();
+        POTHOS_TEST_TRUE(topology.waitInactive(0.01));
+    }
+
+    return collectors;
+}
+
 }
@@ -164,6 +164,34 @@ void testBufferChunk(
     const Pothos::BufferChunk& expectedBufferChunk,
     const Pothos::BufferChunk& actualBufferChunk);
 
+//
+// Running blocks
+//
+
+// Returns a feeder source that feeds the inputs in buffers of at most
+// chunkSize elements, or in one buffer if chunkSize is 0. Buffers that don't
+// line up with a block's frames or intervals test that its state carries
+// over between work calls.
+Pothos::Proxy feedInChunks(
+    const Pothos::BufferChunk& inputs,
+    size_t chunkSize = 0);
+
+template <typename T>
+static Pothos::Proxy feedInChunks(
+    const std::vector<T>& inputs,
+    size_t chunkSize = 0)
+{
+    return feedInChunks(stdVectorToBufferChunk(inputs), chunkSize);
+}
+
+// Connects each feeder to the block input of the same index and each block
+// output to a collector sink of the given type, runs the topology until it's
+// inactive, and returns the collector sinks.
+std::vector<Pothos::Proxy> runBlock(
+    const Pothos::Proxy& block,
+    const std::vector<Pothos::Proxy>& feeders,
+    const std::vector<Pothos::DType>& outputDTypes);
+
 template <typename ReturnType, typename... ArgsType>
 ReturnType getAndCallPlugin(
     const std::string& proxyPath,
@@ -0,0 +1,134 @@
+// Copyright (c) 2019-2020 Nicholas Corgan
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "TestUtility.hpp"
+
+#include <Pothos/Testing.hpp>
+#include <Pothos/Framework.hpp>
+#include <Pothos/Proxy.hpp>
+
+#include <complex>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+static constexpr size_t Dimension = 8;
+static constexpr size_t NumFrames = 16;
+
+template <typename T>
+static Pothos::BufferChunk stdVectorToFrames(const std::vector<T>& vectorIn)
+{
+    const Pothos::DType dtype(Pothos::DType(typeid(T)).name(), Dimension);
+
+    auto ret = Pothos::BufferChunk(dtype, (vectorIn.size() / Dimension));
+    std::memcpy(ret.as<T*>(), vectorIn.data(), ret.length);
+
+    return ret;
+}
+
+// Vector buffers can't be compared directly, so compare their values.
+static Pothos::BufferChunk framesToScalarBufferChunk(const Pothos::BufferChunk& frames)
+{
+    const Pothos::DType dtype(frames.dtype.name());
+
+    auto ret = Pothos::BufferChunk(dtype, (frames.elements() * frames.dtype.dimension()));
+    std::memcpy((void*)ret.address, (const void*)frames.address, ret.length);
+
+    return ret;
+}
+
+static void testElementwise()
+{
+    const Pothos::DType dtype("float64", Dimension);
+
+    const auto inputs0 = NPTests::linspace<double>(-10, 10, (Dimension * NumFrames));
+    const auto inputs1 = NPTests::linspace<double>(5, 50, (Dimension * NumFrames));
+
+    std::vector<double> expectedOutputs;
+    for(size_t i = 0; i < inputs0.size(); ++i)
+    {
+        expectedOutputs.emplace_back(inputs0[i] + inputs1[i]);
+    }
+
+    std::cout << " * /numpy/add" << std::endl;
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(expectedOutputs),
+        framesToScalarBufferChunk(NPTests::runBlock(
+            Pothos::BlockRegistry::make("/numpy/add", dtype, 2),
+            {NPTests::feedInChunks(stdVectorToFrames(inputs0)), NPTests::feedInChunks(stdVectorToFrames(inputs1))},
+            {dtype})[0].call("getBuffer")));
+}
+
+static void testFrameStats()
+{
+    const Pothos::DType dtype("float64", Dimension);
+
+    const auto inputs = NPTests::linspace<double>(-10, 10, (Dimension * NumFrames));
+
+    std::cout << " * /numpy/mean" << std::endl;
+
+    const auto collector = NPTests::runBlock(
+                               Pothos::BlockRegistry::make("/numpy/mean", dtype, false),
+                               {NPTests::feedInChunks(stdVectorToFrames(inputs))},
+                               {dtype})[0];
+    const auto outputs = collector.call<Pothos::BufferChunk>("getBuffer");
+    const auto labels = collector.call<std::vector<Pothos::Label>>("getLabels");
+
+    // The input should be forwarded, with one label per frame.
+    NPTests::testBufferChunk(
+        NPTests::stdVectorToBufferChunk(inputs),
+        framesToScalarBufferChunk(outputs));
+    POTHOS_TEST_EQUAL(NumFrames, labels.size());
+
+    for(size_t frame = 0; frame < NumFrames; ++frame)
+    {
+        const auto frameBegin = inputs.begin() + (frame * Dimension);
+        const auto expectedMean = std::accumulate(frameBegin, (frameBegin + Dimension), 0.0) / Dimension;
+
+        POTHOS_TEST_EQUAL("MEAN", labels[frame].id);
+        POTHOS_TEST_EQUAL(frame, labels[frame].index);
+        POTHOS_TEST_CLOSE(expectedMean, labels[frame].data.convert<double>(), 1e-6);
+    }
+}
+
+static void testFrameFFT()
+{
+    const Pothos::DType scalarDType("complex_float64");
+    const Pothos::DType dtype(scalarDType.name(), Dimension);
+
+    std::vector<std::complex<double>> inputs;
+    for(const auto& value: NPTests::linspace<double>(-10, 10, (Dimension * NumFrames)))
+    {
+        inputs.emplace_back(value, -value);
+    }
+
+    std::cout << " * /numpy/fft/fft" << std::endl;
+
+    // Transforming vector frames should give the same result as transforming
+    // the equivalent scalar stream.
+    const auto scalarOutputs = NPTests::runBlock(
+                                   Pothos::BlockRegistry::make("/numpy/fft/fft", scalarDType, Dimension),
+                                   {NPTests::feedInChunks(inputs)},
+                                   {scalarDType})[0].call<Pothos::BufferChunk>("getBuffer");
+    const auto vectorOutputs = NPTests::runBlock(
+                                   Pothos::BlockRegistry::make("/numpy/fft/fft", dtype, Dimension),
+                                   {NPTests::feedInChunks(stdVectorToFrames(inputs))},
+                                   {dtype})[0].call<Pothos::BufferChunk>("getBuffer");
+    NPTests::testBufferChunk(
+        scalarOutputs,
+        framesToScalarBufferChunk(vectorOutputs));
+
+    // The number of bins must match the dimension.
+    POTHOS_TEST_THROWS(
+        Pothos::BlockRegistry::make("/numpy/fft/fft", dtype, (Dimension * 2)),
+        Pothos::ProxyExceptionMessage);
+}
+
+POTHOS_TEST_BLOCK("/numpy/tests", test_vector_dtype)
+{
+    testElementwise();
+    testFrameStats();
+    testFrameFFT();
+}